@@ -0,0 +1,474 @@
+/********************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2019 Jakub Wlodek
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *********************************************************************************/
+
+/**
+ * Benchmarks for the csplit library.
+ *
+ * Generates synthetic datasets from a seed, so runs with the same seed split the same bytes,
+ * then times csplit, csplit_lim, rcsplit and csplit_strip on every line of each dataset.
+ * strtok_r, strsep and a plain memchr loop are timed on the same lines for comparison.
+ * Results, including the number of heap allocations made by each method, are written as JSON.
+ *
+ * Usage: csplit_bench [-s seed] [-t min_seconds] [-o output.json]
+ *
+ * Author: Jakub Wlodek
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+
+// count the allocations made by csplit, by passing counting versions of malloc, calloc and realloc
+// to the allocator macros of csplit.h
+static size_t num_allocs = 0;
+static size_t alloc_bytes = 0;
+
+static void* bench_malloc(size_t size){
+    num_allocs++;
+    alloc_bytes = alloc_bytes + size;
+    return malloc(size);
+}
+
+static void* bench_calloc(size_t num, size_t size){
+    num_allocs++;
+    alloc_bytes = alloc_bytes + num * size;
+    return calloc(num, size);
+}
+
+static void* bench_realloc(void* ptr, size_t size){
+    num_allocs++;
+    alloc_bytes = alloc_bytes + size;
+    return realloc(ptr, size);
+}
+
+#define CSPLIT_MALLOC(size) bench_malloc(size)
+#define CSPLIT_CALLOC(num, size) bench_calloc(num, size)
+#define CSPLIT_REALLOC(ptr, size) bench_realloc(ptr, size)
+#define CSPLIT_FREE(ptr) free(ptr)
+#include "csplit.h"
+
+
+/**
+ * A generated dataset. Lines are stored one after another, each followed by a NUL character.
+ */
+typedef struct BENCH_DATASET {
+    const char* name;       /**< Name of the dataset in the output */
+    size_t line_len;        /**< Average length of a line */
+    size_t num_fields;      /**< Number of fields in every line */
+    const char* token;      /**< Token separating the fields */
+    char* data;             /**< Lines of the dataset */
+    size_t* offsets;        /**< Offset of each line in data */
+    size_t num_lines;       /**< Number of lines */
+    size_t num_bytes;       /**< Number of bytes in all lines, not counting the NUL characters */
+} BenchDataset_t;
+
+
+/**
+ * A method being timed. Splits every line of the dataset and returns the number of fragments found.
+ */
+typedef struct BENCH_METHOD {
+    const char* name;                               /**< Name of the method in the output */
+    int single_byte_only;                           /**< Set if the method treats a token as a set of characters */
+    int all_fields;                                 /**< Set if the method finds every field, checked against the dataset */
+    size_t (*run)(BenchDataset_t* dataset, char* scratch);
+} BenchMethod_t;
+
+
+// Total bytes generated for each dataset
+#define BENCH_DATASET_BYTES (8 << 20)
+
+static BenchDataset_t datasets[] = {
+    {"short_many_fields", 64, 16, ",", NULL, NULL, 0, 0},
+    {"short_few_fields", 64, 2, ",", NULL, NULL, 0, 0},
+    {"long_many_fields", 65536, 8192, ",", NULL, NULL, 0, 0},
+    {"long_few_fields", 65536, 4, ",", NULL, NULL, 0, 0},
+    {"short_many_fields_multibyte", 64, 16, "::", NULL, NULL, 0, 0},
+    {"long_many_fields_multibyte", 65536, 8192, "::", NULL, NULL, 0, 0},
+};
+
+static uint64_t rng_state;
+
+
+/**
+ * xorshift64 random number generator, so datasets only depend on the seed
+ */
+static uint64_t bench_rand(void){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+
+/**
+ * Function that generates the lines of a dataset. Fields are random letters and digits of random
+ * length, never empty, and every line is padded with a few spaces at either end for csplit_strip.
+ */
+static void generate_dataset(BenchDataset_t* dataset){
+    size_t token_len = strlen(dataset->token);
+    size_t field_len = (dataset->line_len - (dataset->num_fields - 1) * token_len) / dataset->num_fields;
+    size_t max_line = dataset->line_len * 2 + 16;
+    size_t capacity = BENCH_DATASET_BYTES / dataset->line_len + 1;
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    size_t pos = 0;
+    size_t i, j, k;
+
+    dataset->data = (char*) malloc(BENCH_DATASET_BYTES + max_line);
+    dataset->offsets = (size_t*) malloc(capacity * sizeof(size_t));
+    if(dataset->data == NULL || dataset->offsets == NULL){
+        fprintf(stderr, "Failed to allocate dataset %s\n", dataset->name);
+        exit(1);
+    }
+    dataset->num_lines = 0;
+    dataset->num_bytes = 0;
+    while(pos < BENCH_DATASET_BYTES && dataset->num_lines < capacity){
+        size_t start = pos;
+        dataset->offsets[dataset->num_lines++] = pos;
+        for(k = bench_rand() % 4; k > 0; k--)
+            dataset->data[pos++] = ' ';
+        for(i = 0; i < dataset->num_fields; i++){
+            // lengths vary between half and one and a half times the average
+            size_t len = field_len / 2 + bench_rand() % (field_len + 1);
+            if(len == 0)
+                len = 1;
+            if(i > 0){
+                memcpy(dataset->data + pos, dataset->token, token_len);
+                pos = pos + token_len;
+            }
+            for(j = 0; j < len; j++)
+                dataset->data[pos++] = alphabet[bench_rand() % (sizeof(alphabet) - 1)];
+        }
+        for(k = bench_rand() % 4; k > 0; k--)
+            dataset->data[pos++] = ' ';
+        dataset->num_bytes = dataset->num_bytes + (pos - start);
+        dataset->data[pos++] = '\0';
+    }
+}
+
+
+/**
+ * Returns the length of the longest line, for the scratch buffer of the strtok_r and strsep methods
+ */
+static size_t longest_line(BenchDataset_t* dataset){
+    size_t longest = 0;
+    size_t i;
+    for(i = 0; i < dataset->num_lines; i++){
+        size_t len = strlen(dataset->data + dataset->offsets[i]);
+        if(len > longest)
+            longest = len;
+    }
+    return longest;
+}
+
+
+static size_t run_csplit(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        CSplitList_t* list = csplit_init_list();
+        csplit(list, dataset->data + dataset->offsets[i], (char*) dataset->token);
+        total = total + list->num_elems;
+        csplit_clear_list(list);
+    }
+    return total;
+}
+
+
+static size_t run_csplit_reset(BenchDataset_t* dataset, char* scratch){
+    CSplitList_t* list = csplit_init_list();
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        csplit_reset_list(list, 0);
+        csplit(list, dataset->data + dataset->offsets[i], (char*) dataset->token);
+        total = total + list->num_elems;
+    }
+    csplit_clear_list(list);
+    return total;
+}
+
+
+// counts first, then splits into one allocation holding the pointer table and all texts, counted with
+// the same hook as the allocations of csplit
+static size_t run_csplit_count_fill(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        const char* line = dataset->data + dataset->offsets[i];
+        size_t num_fragments, total_bytes;
+        if(csplit_count(line, dataset->token, INT_MAX, &num_fragments, &total_bytes) != CSPLIT_SUCCESS)
+            continue;
+        char** fields = (char**) bench_malloc(total_bytes);
+        if(csplit_fill(fields, total_bytes, num_fragments, line, dataset->token, INT_MAX) == CSPLIT_SUCCESS)
+            total = total + num_fragments;
+        free(fields);
+    }
+    return total;
+}
+
+
+static size_t run_csplit_lim(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        CSplitList_t* list = csplit_init_list();
+        csplit_lim(list, dataset->data + dataset->offsets[i], (char*) dataset->token, 2);
+        total = total + list->num_elems;
+        csplit_clear_list(list);
+    }
+    return total;
+}
+
+
+static size_t run_rcsplit(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        CSplitList_t* list = csplit_init_list();
+        rcsplit(list, dataset->data + dataset->offsets[i], (char*) dataset->token);
+        total = total + list->num_elems;
+        csplit_clear_list(list);
+    }
+    return total;
+}
+
+
+static size_t run_csplit_strip(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        char* stripped = csplit_strip(dataset->data + dataset->offsets[i]);
+        if(stripped != NULL)
+            total++;
+        free(stripped);
+    }
+    return total;
+}
+
+
+// strtok_r and strsep write into the line, so each line is copied to a scratch buffer first
+static size_t run_strtok_r(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    for(i = 0; i < dataset->num_lines; i++){
+        char* save = NULL;
+        strcpy(scratch, dataset->data + dataset->offsets[i]);
+        char* field = strtok_r(scratch, dataset->token, &save);
+        while(field != NULL){
+            total++;
+            field = strtok_r(NULL, dataset->token, &save);
+        }
+    }
+    return total;
+}
+
+
+static size_t run_strsep(BenchDataset_t* dataset, char* scratch){
+    size_t total = 0;
+    size_t i;
+    for(i = 0; i < dataset->num_lines; i++){
+        char* rest = scratch;
+        strcpy(scratch, dataset->data + dataset->offsets[i]);
+        while(strsep(&rest, dataset->token) != NULL)
+            total++;
+    }
+    return total;
+}
+
+
+// finds the fields without copying them, the lower bound for any split
+static size_t run_memchr(BenchDataset_t* dataset, char* scratch){
+    size_t token_len = strlen(dataset->token);
+    size_t total = 0;
+    size_t i;
+    (void) scratch;
+    for(i = 0; i < dataset->num_lines; i++){
+        const char* cur = dataset->data + dataset->offsets[i];
+        const char* end = cur + strlen(cur);
+        const char* next;
+        total++;
+        while((next = (const char*) memchr(cur, dataset->token[0], end - cur)) != NULL){
+            if((size_t) (end - next) >= token_len && memcmp(next, dataset->token, token_len) == 0){
+                total++;
+                cur = next + token_len;
+            }
+            else
+                cur = next + 1;
+        }
+    }
+    return total;
+}
+
+
+static BenchMethod_t methods[] = {
+    {"csplit", 0, 1, run_csplit},
+    {"csplit_reset_list", 0, 1, run_csplit_reset},
+    {"csplit_count_fill", 0, 1, run_csplit_count_fill},
+    {"csplit_lim", 0, 0, run_csplit_lim},
+    {"rcsplit", 0, 1, run_rcsplit},
+    {"csplit_strip", 0, 0, run_csplit_strip},
+    {"strtok_r", 1, 1, run_strtok_r},
+    {"strsep", 1, 1, run_strsep},
+    {"memchr", 0, 1, run_memchr},
+};
+
+
+static double now_seconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * Times one method on one dataset. The dataset is split repeatedly until min_seconds have passed,
+ * and the fastest of three such trials is kept. Allocations are counted over a single pass.
+ */
+static void bench_method(FILE* fp, BenchDataset_t* dataset, BenchMethod_t* method, char* scratch,
+                         double min_seconds, int first){
+    double best = 0;
+    size_t fragments;
+    size_t allocs, bytes;
+    int trial;
+
+    num_allocs = 0;
+    alloc_bytes = 0;
+    fragments = method->run(dataset, scratch);
+    allocs = num_allocs;
+    bytes = alloc_bytes;
+    if(method->all_fields && fragments != dataset->num_lines * dataset->num_fields){
+        fprintf(stderr, "%s found %zu fragments in %s, expected %zu, exiting.\n", method->name, fragments,
+                dataset->name, dataset->num_lines * dataset->num_fields);
+        exit(1);
+    }
+
+    for(trial = 0; trial < 3; trial++){
+        double start = now_seconds();
+        double elapsed;
+        size_t passes = 0;
+        do {
+            method->run(dataset, scratch);
+            passes++;
+            elapsed = now_seconds() - start;
+        } while(elapsed < min_seconds);
+        elapsed = elapsed / passes;
+        if(trial == 0 || elapsed < best)
+            best = elapsed;
+    }
+
+    fprintf(stderr, "%-28s %-18s %8.3f GB/s %10.1f Mfragments/s %10zu allocs\n", dataset->name, method->name,
+            dataset->num_bytes / best * 1e-9, fragments / best * 1e-6, allocs);
+    fprintf(fp, "%s    {\"dataset\": \"%s\", \"method\": \"%s\", \"seconds_per_pass\": %.9f, "
+            "\"gb_per_s\": %.4f, \"fragments_per_s\": %.1f, \"fragments\": %zu, "
+            "\"allocs\": %zu, \"alloc_bytes\": %zu, \"allocs_per_line\": %.3f}",
+            first ? "" : ",\n", dataset->name, method->name, best, dataset->num_bytes / best * 1e-9,
+            fragments / best, fragments, allocs, bytes, (double) allocs / dataset->num_lines);
+}
+
+
+int main(int argc, char** argv){
+    uint64_t seed = 1;
+    double min_seconds = 0.2;
+    const char* output_path = NULL;
+    FILE* fp = stdout;
+    size_t num_datasets = sizeof(datasets) / sizeof(datasets[0]);
+    size_t num_methods = sizeof(methods) / sizeof(methods[0]);
+    size_t d, m;
+    int i, first = 1;
+
+    for(i = 1; i < argc; i++){
+        if(strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            min_seconds = atof(argv[++i]);
+        else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output_path = argv[++i];
+        else{
+            fprintf(stderr, "Usage: %s [-s seed] [-t min_seconds] [-o output.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(output_path != NULL){
+        fp = fopen(output_path, "w");
+        if(fp == NULL){
+            fprintf(stderr, "Failed to open %s, exiting.\n", output_path);
+            return 1;
+        }
+    }
+
+    fprintf(fp, "{\n  \"seed\": %llu,\n  \"min_seconds\": %g,\n", (unsigned long long) seed, min_seconds);
+#if defined(CSPLIT_AVX2)
+    fprintf(fp, "  \"simd\": \"avx2\",\n");
+#elif defined(CSPLIT_SSE2)
+    fprintf(fp, "  \"simd\": \"sse2\",\n");
+#else
+    fprintf(fp, "  \"simd\": \"none\",\n");
+#endif
+    fprintf(fp, "  \"datasets\": [\n");
+    for(d = 0; d < num_datasets; d++){
+        BenchDataset_t* dataset = &datasets[d];
+        // each dataset gets its own stream, so adding a dataset does not change the others
+        rng_state = seed * 0x9E3779B97F4A7C15ULL + d + 1;
+        generate_dataset(dataset);
+        fprintf(fp, "    {\"name\": \"%s\", \"token\": \"%s\", \"lines\": %zu, \"bytes\": %zu, "
+                "\"fields_per_line\": %zu}%s\n", dataset->name, dataset->token, dataset->num_lines,
+                dataset->num_bytes, dataset->num_fields, d + 1 < num_datasets ? "," : "");
+    }
+    fprintf(fp, "  ],\n  \"results\": [\n");
+
+    for(d = 0; d < num_datasets; d++){
+        BenchDataset_t* dataset = &datasets[d];
+        int single_byte = strlen(dataset->token) == 1;
+        char* scratch = (char*) malloc(longest_line(dataset) + 1);
+        if(scratch == NULL){
+            fprintf(stderr, "Failed to allocate scratch buffer, exiting.\n");
+            return 1;
+        }
+        for(m = 0; m < num_methods; m++){
+            if(methods[m].single_byte_only && !single_byte)
+                continue;
+            bench_method(fp, dataset, &methods[m], scratch, min_seconds, first);
+            first = 0;
+        }
+        free(scratch);
+        free(dataset->data);
+        free(dataset->offsets);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    if(output_path != NULL)
+        fclose(fp);
+    return 0;
+}
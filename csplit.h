@@ -43,6 +43,87 @@
 #ifndef CSPLIT_H
 #define CSPLIT_H
 
+// SIMD scanning is used when the compiler targets SSE2 or AVX2. Define CSPLIT_NO_SIMD to
+// always use the scalar versions of the scanning functions.
+#if !defined(CSPLIT_NO_SIMD) && defined(__AVX2__)
+# include <immintrin.h>
+# define CSPLIT_AVX2
+# define CSPLIT_SIMD_WIDTH 32
+# if defined(__AVX512VBMI2__) && defined(__AVX512BW__)
+#  define CSPLIT_AVX512_COMPRESS
+# endif
+#elif !defined(CSPLIT_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+# include <emmintrin.h>
+# define CSPLIT_SSE2
+# define CSPLIT_SIMD_WIDTH 16
+# ifdef __SSSE3__
+#  include <tmmintrin.h>
+#  define CSPLIT_SSSE3
+# endif
+#endif
+
+#if defined(CSPLIT_SIMD_WIDTH) && defined(_MSC_VER) && !defined(__clang__)
+# include <intrin.h>
+#endif
+
+// Quoted regions of csv input are found with a carry-less multiply when the compiler targets PCLMUL.
+#if defined(CSPLIT_SIMD_WIDTH) && defined(__PCLMUL__) && (defined(__x86_64__) || defined(_M_X64))
+# include <wmmintrin.h>
+# define CSPLIT_CLMUL
+#endif
+
+// Files are split in place through mmap on POSIX systems. Define CSPLIT_NO_MMAP to always read
+// files in chunks instead.
+#if !defined(CSPLIT_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <errno.h>
+# define CSPLIT_MMAP
+#endif
+
+// Parallel splitting uses POSIX threads, so it is only compiled if CSPLIT_THREADS is defined.
+// Programs that define it must be linked with -pthread.
+#ifdef CSPLIT_THREADS
+# include <pthread.h>
+# include <unistd.h>
+#endif
+
+// Memory owned by csplit comes from CSPLIT_MALLOC, CSPLIT_REALLOC and CSPLIT_FREE. Define all three before including
+// csplit.h to use another allocator. CSPLIT_CALLOC may be defined as well, otherwise it is CSPLIT_MALLOC and memset.
+#if !defined(CSPLIT_MALLOC) && !defined(CSPLIT_REALLOC) && !defined(CSPLIT_FREE)
+# define CSPLIT_MALLOC(size) malloc(size)
+# define CSPLIT_REALLOC(ptr, size) realloc(ptr, size)
+# define CSPLIT_FREE(ptr) free(ptr)
+# ifndef CSPLIT_CALLOC
+#  define CSPLIT_CALLOC(num, size) calloc(num, size)
+# endif
+#elif !defined(CSPLIT_MALLOC) || !defined(CSPLIT_REALLOC) || !defined(CSPLIT_FREE)
+# error "CSPLIT_MALLOC, CSPLIT_REALLOC and CSPLIT_FREE must be defined together"
+#endif
+
+// Define CSPLIT_STATS to count the allocations, copies, scanned bytes, fragments and calls of each thread,
+// read with csplit_get_stats. Without it the counters are not compiled in at all.
+#ifdef CSPLIT_STATS
+# if defined(_MSC_VER)
+#  define CSPLIT_THREAD_LOCAL __declspec(thread)
+# elif defined(__cplusplus) && __cplusplus >= 201103L
+#  define CSPLIT_THREAD_LOCAL thread_local
+# elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#  define CSPLIT_THREAD_LOCAL _Thread_local
+# else
+#  define CSPLIT_THREAD_LOCAL __thread
+# endif
+#endif
+
+// Integer fields are parsed eight digits at a time by loading them into one 64 bit word, which needs the first
+// digit in the lowest byte. Other byte orders parse one digit at a time.
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+# define CSPLIT_LITTLE_ENDIAN
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,7 +132,36 @@ extern "C" {
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
 #include <ctype.h>
+#include <float.h>
+#include <errno.h>
+
+// Default size of the first block of an arena backed list, used if no size is given
+#ifndef CSPLIT_ARENA_BLOCK_SIZE
+#define CSPLIT_ARENA_BLOCK_SIZE 4096
+#endif
+
+// Alignment of allocations made from an arena backed list
+#define CSPLIT_ARENA_ALIGN sizeof(void*)
+
+// Size of the chunks read from a file that can not be mapped, such as a pipe
+#ifndef CSPLIT_FILE_CHUNK_SIZE
+#define CSPLIT_FILE_CHUNK_SIZE 65536
+#endif
+
+// Smallest number of input bytes given to each thread by a parallel split
+#ifndef CSPLIT_PARALLEL_MIN_CHUNK
+#define CSPLIT_PARALLEL_MIN_CHUNK (1 << 20)
+#endif
+
+// Compiled tokens longer than this are searched for with the two-way algorithm, which is linear
+// in the worst case. Shorter tokens are found by filtering on their first and last bytes.
+#ifndef CSPLIT_TWO_WAY_MIN_LEN
+#define CSPLIT_TWO_WAY_MIN_LEN 32
+#endif
 
 #ifdef _MSC_VER
 # define _CSPLIT_FUNC static __inline
@@ -71,6 +181,9 @@ typedef enum CSPLIT_ERROR {
     CSPLIT_NO_SUCH_INDEX    = -2,    /**< Index out of range */
     CSPLIT_UNIMPLEMENTED    = -3,    /**< Function unimplemented */
     CSPLIT_BUFF_EXCEEDED    = -4,    /**< Buffer size exceeded */
+    CSPLIT_IO_ERROR         = -5,    /**< Failed to read input file */
+    CSPLIT_PARSE_ERROR      = -6,    /**< Field is not a number */
+    CSPLIT_OUT_OF_RANGE     = -7,    /**< Number does not fit in the output type */
 } CSplitError_t;
 
 
@@ -82,9 +195,34 @@ typedef struct CSPLIT_FRAGMENT {
     char* text;                         /**< Text of the fragment. */
     struct CSPLIT_FRAGMENT* next;       /**< Next fragment in the linked list */
     struct CSPLIT_FRAGMENT* prev;       /**< Previous fragment in the linked list */
+    size_t text_cap;                    /**< Number of bytes allocated for text, for reuse after csplit_reset_list */
 } CSplitFragment_t;
 
 
+/**
+ * Struct for a block of memory owned by an arena backed csplit list. The usable memory
+ * directly follows this header.
+ * @ingroup intern
+ */
+typedef struct CSPLIT_ARENA_BLOCK {
+    struct CSPLIT_ARENA_BLOCK* next;    /**< Previously allocated block, or NULL for the first one */
+    size_t size;                        /**< Number of usable bytes in the block */
+    size_t used;                        /**< Number of bytes already handed out from the block */
+} CSplitArenaBlock_t;
+
+
+/**
+ * Struct of functions that allocate the memory of a list and its fragments, set with csplit_init_allocator_list.
+ * free is given the size passed to alloc, so pool or slab allocators tuned to fragment sizes can be used.
+ * @ingroup set
+ */
+typedef struct CSPLIT_ALLOCATOR {
+    void* (*alloc)(void* user_data, size_t size);           /**< Returns size bytes of memory, or NULL */
+    void (*free)(void* user_data, void* ptr, size_t size);  /**< Frees memory returned by alloc, given its size */
+    void* user_data;                                        /**< Passed to alloc and free */
+} CSplitAllocator_t;
+
+
 /**
  * Struct that stores the csplit linked list. Can be used as an arbitrary linked list
  * for strings, but is intended for use with csplit strtok replacement functions
@@ -94,17 +232,324 @@ typedef struct CSPLIT_LIST {
     int num_elems;              /**< Number of elements in the list */
     CSplitFragment_t* head;     /**< Head of the linked list (first element) */
     CSplitFragment_t* tail;     /**< Tail of the linked list (last element) */
+    CSplitArenaBlock_t* arena;  /**< Newest arena block if created with csplit_init_arena_list, otherwise NULL */
+    CSplitFragment_t* spare;    /**< Fragments kept by csplit_reset_list for reuse, linked by next */
+    CSplitAllocator_t allocator;    /**< Allocator of the list and its fragments, with alloc NULL for CSPLIT_MALLOC */
 } CSplitList_t;
 
 
+/**
+ * Struct for a zero-copy view of a string fragment. The text points into the input string that
+ * was split, and is not NUL terminated, so len must be used when reading it.
+ * @ingroup core
+ */
+typedef struct CSPLIT_VIEW {
+    const char* text;           /**< Start of the fragment inside the input string */
+    size_t len;                 /**< Length of the fragment in bytes */
+} CSplitView_t;
+
+
+/**
+ * Struct that stores split results as a contiguous array of views, for constant time access by index
+ * and constant time reversal. Views point into the input strings, which must outlive the array.
+ * @ingroup core
+ */
+typedef struct CSPLIT_ARRAY {
+    CSplitView_t* elems;        /**< Fragment views, in the order they were added */
+    size_t num_elems;           /**< Number of elements in the array */
+    size_t capacity;            /**< Number of elements allocated in elems */
+    int reversed;               /**< Nonzero if the elements are read back to front */
+} CSplitArray_t;
+
+
+/**
+ * Struct for a token that has been preprocessed once, so it can be used for many splits without
+ * any per call setup. Created with csplit_compile_token.
+ * @ingroup core
+ */
+typedef struct CSPLIT_TOKEN {
+    const char* text;           /**< Text of the token. Not copied, so it must outlive the compiled token */
+    size_t len;                 /**< Length of the token in bytes */
+    int two_way;                /**< Nonzero if the token is long enough to use the two-way search */
+    int periodic;               /**< Nonzero if the token is periodic, for the two-way search */
+    size_t critical_pos;        /**< Position of the critical factorization, for the two-way search */
+    size_t period;              /**< Period used for shifting on a mismatch, for the two-way search */
+    size_t shift[256];          /**< Shift for each value of the last byte of a window, for the two-way search */
+    int rev_periodic;           /**< Nonzero if the reversed token is periodic, for the reverse two-way search */
+    size_t rev_critical_pos;    /**< Critical factorization of the reversed token, for the reverse two-way search */
+    size_t rev_period;          /**< Period of the reversed token, for the reverse two-way search */
+    size_t rev_shift[256];      /**< Shift for each value of the first byte of a window, for the reverse two-way search */
+} CSplitToken_t;
+
+
+/**
+ * Struct that stores a set of single byte delimiters, any of which splits the input. Built once with
+ * csplit_compile_charset, it holds a bitmap of the set, and nibble lookup tables used to classify
+ * a block of bytes at once with SIMD.
+ * @ingroup core
+ */
+typedef struct CSPLIT_CHARSET {
+    uint8_t bits[32];           /**< Bitmap with bit c set if byte c is in the set */
+    uint8_t lo_table[16];       /**< For each low nibble, bit h set if the byte with high nibble h is in the set, for h < 8 */
+    uint8_t lo_table_high[16];  /**< Same as lo_table for the high nibbles 8 to 15, in bits h - 8 */
+    int has_high;               /**< Nonzero if the set contains a byte of 0x80 or more */
+    size_t num_members;         /**< Number of bytes in the set */
+    char members[16];           /**< The first bytes of the set, compared against directly without SSSE3 */
+} CSplitCharset_t;
+
+
+/**
+ * Struct that stores the state of a split in progress. All split functions share it, so that
+ * there is only one implementation of the scanning logic. It can also be used directly, with
+ * csplit_iter_init and csplit_iter_next, to read fragments one at a time without allocating.
+ * @ingroup core
+ */
+typedef struct CSPLIT_ITER {
+    const char* begin;          /**< Start of the input string */
+    const char* end;            /**< End of the input string (one past the last byte) */
+    const char* pos;            /**< Start of the next fragment, or its end when splitting in reverse */
+    const char* token;          /**< Token on which to split */
+    size_t token_len;           /**< Length of the token */
+    const CSplitToken_t* compiled;  /**< Compiled version of the token, or NULL */
+    const CSplitCharset_t* charset; /**< Set of single byte delimiters to split on instead of the token, or NULL */
+    int whitespace;             /**< Nonzero if splitting on runs of whitespace instead of the token */
+    size_t splits_left;         /**< Number of splits that may still be performed */
+    int reverse;                /**< Nonzero if splitting from the end of the input string */
+    int done;                   /**< Nonzero once the last fragment has been returned */
+    size_t block_off;           /**< Offset of the next block to scan for a single byte token, or its end in reverse */
+    size_t mask_off;            /**< Offset of the block described by mask */
+    uint32_t mask;              /**< Bitmask of token positions in the last scanned block not yet returned */
+} CSplitIter_t;
+
+
+/**
+ * Type of the function called by csplit_foreach for each fragment. The fragment is a view into the
+ * input string, and is not NUL terminated. Returning nonzero stops the split early.
+ * @ingroup core
+ */
+typedef int (*CSplitCallback_t)(const CSplitView_t* fragment, void* user_data);
+
+
+/**
+ * Struct that stores the state of a split over input that arrives in chunks, such as from read() or a socket.
+ * Fragments that lie inside one chunk are returned as views into it, and only the unfinished fragment at the
+ * end of a chunk is copied, so memory use is bounded by the longest fragment.
+ * @ingroup core
+ */
+typedef struct CSPLIT_STREAM {
+    char* token;                /**< Copy of the token on which to split, owned by the stream */
+    size_t token_len;           /**< Length of the token */
+    char* carry;                /**< Start of the fragment left unfinished at the end of the previous chunks */
+    size_t carry_len;           /**< Number of bytes in carry */
+    size_t carry_cap;           /**< Number of bytes allocated for carry */
+    size_t carry_scanned;       /**< Number of leading bytes of carry already known not to start a token */
+    int carry_emitted;          /**< Nonzero if carry was returned as a fragment, and must be emptied */
+    const char* chunk;          /**< Chunk currently being split, or NULL once it was consumed */
+    size_t chunk_len;           /**< Length of the chunk */
+    int joined;                 /**< Nonzero once carry was checked for a token that ends in the chunk */
+    int iter_ready;             /**< Nonzero once iter was set up on the chunk */
+    CSplitIter_t iter;          /**< Scanner over the chunk */
+    int finished;               /**< Nonzero once the end of the stream was signaled */
+    int done;                   /**< Nonzero once the last fragment was returned */
+    CSplitError_t err;          /**< First error hit by the stream, returned by every later call */
+} CSplitStream_t;
+
+
+/**
+ * Struct that stores the state of a file being split into records. Regular files are mapped into memory
+ * and split in place, anything else is read in chunks of CSPLIT_FILE_CHUNK_SIZE bytes and split by a stream.
+ * @ingroup core
+ */
+typedef struct CSPLIT_FILE {
+    const char* data;           /**< Mapped contents of the file, or NULL if the file is read in chunks */
+    size_t len;                 /**< Length of the mapped file */
+    char* token;                /**< Copy of the token that ends each record, owned by the file */
+    size_t token_len;           /**< Length of the token */
+    CSplitIter_t records;       /**< Record scanner over the mapped file */
+    CSplitStream_t* stream;     /**< Record splitter over the chunks read from the file, if it is not mapped */
+    char* buffer;               /**< Buffer for the chunks read from the file, if it is not mapped */
+    int eof;                    /**< Nonzero once the whole file was read */
+    CSplitView_t record;        /**< Record returned by the last call to csplit_file_next */
+    int record_pending;         /**< Nonzero if record could not be split, and must be returned again */
+#ifdef CSPLIT_MMAP
+    int fd;                     /**< Descriptor of the open file */
+#else
+    FILE* fp;                   /**< Handle of the open file */
+#endif
+} CSplitFile_t;
+
+
+/**
+ * Struct that stores the state of an RFC 4180 csv parser. The input is classified 64 bytes at a time into a mask
+ * of the delimiters and newlines that are outside quotes, so records and fields are found without looking at
+ * each byte. Fields are views into the input, except those with doubled quotes, which are unescaped into a buffer.
+ * @ingroup core
+ */
+typedef struct CSPLIT_CSV {
+    const char* data;           /**< Input being parsed. Must outlive the parser */
+    size_t len;                 /**< Length of the input */
+    char delimiter;             /**< Byte that separates fields */
+    size_t pos;                 /**< Offset of the start of the next record */
+    size_t block_off;           /**< Offset of the 64 byte block that structural covers */
+    int block_ready;            /**< Nonzero once structural was computed for the block at block_off */
+    uint64_t structural;        /**< Delimiters and newlines outside quotes in the block, not yet consumed */
+    uint64_t in_quote;          /**< All ones if the block after the current one starts inside quotes */
+    char* unescaped;            /**< Buffer holding the unescaped fields of the current record */
+    size_t unescaped_cap;       /**< Number of bytes allocated for unescaped */
+} CSplitCsv_t;
+
+
+/**
+ * Struct for one slot of the hash table of a config. The key and value are NUL terminated copies in the arena.
+ * @ingroup intern
+ */
+typedef struct CSPLIT_CONFIG_ENTRY {
+    uint64_t hash;              /**< Hash of the key */
+    const char* key;            /**< Key of the entry, or NULL if the slot is empty */
+    size_t key_len;             /**< Length of the key */
+    const char* value;          /**< Value of the entry */
+    size_t value_len;           /**< Length of the value */
+} CSplitConfigEntry_t;
+
+
+/**
+ * Struct that stores key/value pairs loaded from a config. The pairs are kept in an open addressing hash
+ * table, and the table, the keys, the values, and this struct itself all live in a single arena.
+ * @ingroup core
+ */
+typedef struct CSPLIT_CONFIG {
+    CSplitArenaBlock_t* arena;      /**< Newest block of the arena holding the config */
+    CSplitConfigEntry_t* entries;   /**< Hash table of entries, probed linearly */
+    size_t capacity;                /**< Number of slots in entries, a power of two */
+    size_t num_entries;             /**< Number of keys stored */
+} CSplitConfig_t;
+
+
+/**
+ * Struct that stores the result of splitting many inputs at once, in compressed sparse row form. The fragments
+ * of every input are stored one input after another, and starts gives the index of the first fragment of each.
+ * The struct, starts, and fragments share a single allocation. Fragments point into the inputs.
+ * @ingroup core
+ */
+typedef struct CSPLIT_BATCH {
+    CSplitView_t* fragments;    /**< Fragments of every input, in input order */
+    size_t num_fragments;       /**< Total number of fragments */
+    size_t* starts;             /**< Index of the first fragment of each input, followed by num_fragments */
+    size_t num_inputs;          /**< Number of inputs split */
+    size_t capacity;            /**< Number of fragments that fit in the allocation */
+} CSplitBatch_t;
+
+
+#ifdef CSPLIT_STATS
+/**
+ * Enum of the groups of functions whose calls are counted with CSPLIT_STATS
+ * @ingroup set
+ */
+typedef enum CSPLIT_STATS_CALL {
+    CSPLIT_CALL_LIST = 0,               /**< Splits into a CSplitList_t */
+    CSPLIT_CALL_VIEW,                   /**< Splits into caller owned views */
+    CSPLIT_CALL_ARRAY,                  /**< Splits into a CSplitArray_t */
+    CSPLIT_CALL_ITER,                   /**< Iterators initialized */
+    CSPLIT_CALL_FOREACH,                /**< Calls to csplit_foreach */
+    CSPLIT_CALL_STREAM,                 /**< Chunks fed to a stream */
+    CSPLIT_CALL_FILE,                   /**< Files opened */
+    CSPLIT_CALL_PARALLEL,               /**< Parallel splits */
+    CSPLIT_CALL_CSV,                    /**< Csv records read */
+    CSPLIT_CALL_CONFIG,                 /**< Configs loaded */
+    CSPLIT_CALL_BATCH,                  /**< Batch splits */
+    CSPLIT_CALL_STRIP,                  /**< Strips of leading and trailing whitespace */
+    CSPLIT_CALL_REMOVE_WHITESPACE,      /**< Removals of all whitespace */
+    CSPLIT_CALL_PARSE,                  /**< Splits parsed into numbers */
+    CSPLIT_NUM_CALLS                    /**< Number of groups, not a group itself */
+} CSplitStatsCall_t;
+
+
+/**
+ * Struct holding the counters kept for each thread when CSPLIT_STATS is defined
+ * @ingroup set
+ */
+typedef struct CSPLIT_STATS_COUNTERS {
+    size_t allocs;                      /**< Number of calls to malloc, calloc and realloc */
+    size_t bytes_allocated;             /**< Bytes requested by those calls */
+    size_t bytes_copied;                /**< Bytes copied into fragments and other outputs */
+    size_t bytes_scanned;               /**< Input bytes passed over while looking for tokens, records or whitespace */
+    size_t fragments;                   /**< Fragments found, including those used internally such as config lines */
+    size_t calls[CSPLIT_NUM_CALLS];     /**< Number of calls to each group of functions */
+} CSplitStats_t;
+
+
+// Counters of the calling thread. Each file including csplit.h has its own copy.
+static CSPLIT_THREAD_LOCAL CSplitStats_t csplit_stats;
+
+# define CSPLIT_STAT_ADD(counter, n) (csplit_stats.counter += (size_t) (n))
+# define CSPLIT_STAT_CALL(call) (csplit_stats.calls[call]++)
+#else
+# define CSPLIT_STAT_ADD(counter, n) ((void) 0)
+# define CSPLIT_STAT_CALL(call) ((void) 0)
+#endif
+
+
+#ifdef CSPLIT_THREADS
+/**
+ * Struct that stores the part of a parallel split handled by one thread. Each thread first finds the tokens
+ * that start in its chunk, and then copies out the fragments that end in it.
+ * @ingroup intern
+ */
+typedef struct CSPLIT_PARALLEL_CHUNK {
+    const char* data;           /**< Start of the whole input */
+    size_t len;                 /**< Length of the whole input */
+    const char* token;          /**< Token on which to split */
+    size_t token_len;           /**< Length of the token */
+    size_t begin;               /**< Offset of the first position at which the chunk looks for a token */
+    size_t end;                 /**< Offset one past the last position at which the chunk looks for a token */
+    size_t* matches;            /**< Offsets of the tokens found in the chunk, in order */
+    size_t num_matches;         /**< Number of tokens found in the chunk */
+    size_t capacity;            /**< Number of offsets allocated for matches */
+    size_t frag_begin;          /**< Offset of the first fragment that ends in the chunk */
+    int last;                   /**< Nonzero for the last chunk, which also holds the remainder of the input */
+    CSplitList_t* list;         /**< List that receives copies of the fragments, or NULL to fill views */
+    CSplitView_t* views;        /**< Array that receives views of the fragments, if list is NULL */
+    CSplitError_t err;          /**< Error hit by the thread handling the chunk */
+#ifdef CSPLIT_STATS
+    void* (*work)(void*);       /**< Thread function run on the chunk */
+    CSplitStats_t stats;        /**< Counters of the helper thread that handled the chunk */
+#endif
+} CSplitParallelChunk_t;
+#endif
+
+
 /* Function Declarations */
 
 _CSPLIT_FUNC
 CSplitList_t* csplit_init_list();
 
+_CSPLIT_FUNC
+CSplitList_t* csplit_init_arena_list(size_t block_size);
+
 _CSPLIT_FUNC
 void csplit_clear_list(CSplitList_t* list);
 
+_CSPLIT_FUNC
+void csplit_reset_list(CSplitList_t* list, int shrink);
+
+_CSPLIT_FUNC
+void csplit_free_fragments(CSplitList_t* list, CSplitFragment_t* fragment);
+
+_CSPLIT_FUNC
+CSplitArenaBlock_t* csplit_new_arena(size_t block_size, size_t header_size);
+
+_CSPLIT_FUNC
+void* csplit_arena_push(CSplitArenaBlock_t** arena, size_t size);
+
+_CSPLIT_FUNC
+void csplit_free_arena(CSplitArenaBlock_t* arena);
+
+_CSPLIT_FUNC
+void* csplit_arena_alloc(CSplitList_t* list, size_t size);
+
+_CSPLIT_FUNC
+void csplit_append_fragment(CSplitList_t* list, CSplitFragment_t* fragment);
+
 _CSPLIT_FUNC
 CSplitError_t csplit_push_to_list(CSplitList_t* list, CSplitFragment_t* fragment, size_t buff_size);
 
@@ -125,12 +570,36 @@ CSplitError_t csplit_reverse_list(CSplitList_t* list);
 _CSPLIT_FUNC
 char* csplit_strip(char* input_str);
 
+_CSPLIT_FUNC
+char* csplit_strip_n(const char* data, size_t len, size_t* out_len);
+
+_CSPLIT_FUNC
+CSplitView_t csplit_strip_view(const char* data, size_t len);
+
+_CSPLIT_FUNC
+char* csplit_strip_inplace(char* input_str);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_strip_into(char* output_str, size_t out_size, const char* data, size_t len, size_t* out_len);
+
 _CSPLIT_FUNC
 char* csplit_remove_whitespace(char* input_str);
 
+_CSPLIT_FUNC
+size_t csplit_remove_whitespace_inplace(char* input_str);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_remove_whitespace_into(char* output_str, size_t out_size, const char* data, size_t len, size_t* out_len);
+
+_CSPLIT_FUNC
+int csplit_startswith_n(const char* data, size_t len, const char* prefix, size_t prefix_len);
+
 _CSPLIT_FUNC
 int csplit_startswith(char* input_str, char* starts_with);
 
+_CSPLIT_FUNC
+int csplit_endswith_n(const char* data, size_t len, const char* suffix, size_t suffix_len);
+
 _CSPLIT_FUNC
 int csplit_endswith(char* input_str, char* ends_with);
 
@@ -140,438 +609,5620 @@ CSplitError_t csplit_rstr(CSplitList_t* list, char* input_str, char* token, int
 _CSPLIT_FUNC
 CSplitError_t csplit_str(CSplitList_t* list, char* input_str, char* token, int max_splits);
 
+_CSPLIT_FUNC
+CSplitError_t csplit_lim_n(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
 _CSPLIT_FUNC
 CSplitError_t csplit_lim(CSplitList_t* list, char* input_str, char* token, int max_splits);
 
+_CSPLIT_FUNC
+CSplitError_t csplit_n(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len);
+
 _CSPLIT_FUNC
 CSplitError_t csplit(CSplitList_t* list, char* input_str, char* token);
 
 _CSPLIT_FUNC
 CSplitError_t rcsplit(CSplitList_t* output_list, char* input_str, char* token);
 
+_CSPLIT_FUNC
+const char* csplit_find_token(const char* haystack, size_t hay_len, const char* token, size_t token_len);
 
-/* Function Definitions */
+_CSPLIT_FUNC
+const char* csplit_rfind_token(const char* haystack, size_t hay_len, const char* token, size_t token_len);
 
+#ifdef CSPLIT_SIMD_WIDTH
+_CSPLIT_FUNC
+unsigned int csplit_ctz(uint32_t mask);
 
-/**
- * @brief Function for initializing a csplit list
- * @ingroup set
- * 
- * @params[in]: buff_size   -> user set buffer size. Make sure this is large enough for your largest fragment
- * @return: list            -> an allocated csplit list
- */
 _CSPLIT_FUNC
-CSplitList_t* csplit_init_list(){
-    CSplitList_t* list = (CSplitList_t*) calloc(1, sizeof(CSplitList_t));
-    list->num_elems = 0;
-    return list;
-}
+unsigned int csplit_last_bit(uint32_t mask);
 
+_CSPLIT_FUNC
+unsigned int csplit_popcount(uint64_t mask);
 
-/**
- * @brief Clears all memory for an allocated csplit list
- * @ingroup set
- * 
- * @params[in]: list    -> a previously allocated csplit list to be freed
- */
 _CSPLIT_FUNC
-void csplit_clear_list(CSplitList_t* list){
-    CSplitFragment_t* current_fragment = list->head;
-    while(current_fragment != NULL){
-        CSplitFragment_t* temp = current_fragment->next;
-        free(current_fragment->text);
-        free(current_fragment);
-        current_fragment = temp;
-    }
-    free(list);
-}
+uint32_t csplit_byte_mask(const char* block, size_t len, char byte);
 
+_CSPLIT_FUNC
+uint32_t csplit_pair_mask(const char* block, size_t offset, char first, char last);
 
-/**
- * @brief Function that pushes a new CSplitFragment to the end of the list, and allocates memory for the text,
- * with size list->BUFF_SIZE
- * @ingroup intern
- * 
- * @params[out]: list       -> The list with fragment appended to the tail
- * @params[in]: fragment    -> fragment to append to the list. fragment->text will be allocated based on list->BUFF_SIZE
- */
 _CSPLIT_FUNC
-CSplitError_t csplit_push_to_list(CSplitList_t* list, CSplitFragment_t* fragment, size_t buff_size){
-    // first make sure neither is null
-    if(list == NULL || fragment == NULL){
-        return CSPLIT_TOO_SHORT;
-    }
-    else{
-        // then update the number of elements, and the pointers
-        list->num_elems = list->num_elems + 1;
-        if(list->head == NULL){
-            list->head = fragment;
-            list->tail = fragment;
-        }
-        else{
-            list->tail->next = fragment;
-            fragment->prev = list->tail;
-            list->tail = fragment;
-        }
-        // allocate fragment text field
-        fragment->text = (char*) calloc(1, buff_size);
-    }
-    return CSPLIT_SUCCESS;
-}
+uint32_t csplit_charset_mask(const CSplitCharset_t* set, const char* block, size_t len);
 
+_CSPLIT_FUNC
+uint32_t csplit_space_mask(const char* block, size_t len);
+#endif
 
-/**
- * @brief Function that prints information about a csplit list
- * @ingroup set
- * 
- * @params[in]: list    -> list for which to print info
- * @params[in]: fp      -> file pointer to print into.
- */
 _CSPLIT_FUNC
-void csplit_print_list_info(CSplitList_t* list, FILE* fp){
-    if(list == NULL || fp == NULL) return;
-    fprintf(fp, "List contains %d elements\n", list->num_elems);
-    fprintf(fp, "Supports indexes -%d to %d.\n", list->num_elems, list->num_elems -1);
-    CSplitFragment_t* current_fragment = list->head;
-    while(current_fragment != NULL){
-        fprintf(fp, "--%s--\n", current_fragment->text);
-        current_fragment = current_fragment->next;
-    }
-}
+int csplit_is_space(char c);
 
+_CSPLIT_FUNC
+const char* csplit_find_space(const char* current, const char* end, int space);
 
-#ifdef CSPLIT_DEBUG
-/**
- * @brief Function that prints information about a csplit fragment - intended for internal use only
- * @ingroup intern
- * 
- * @params[in]: fragment    -> fragment for which to print info
- * @params[in]: fp          -> file pointer to print into
- */
 _CSPLIT_FUNC
-void print_csplit_fragment_info(CSplitFragment_t* fragment, FILE* fp){
-    if(fragment == NULL || fp == NULL) return;
-    fprintf(fp, "Fragment has text %s\n", fragment->text);
-    if(fragment->next != NULL) fprintf(fp, "Fragment has next with text %s\n", fragment->next->text);
-    if(fragment->prev != NULL) fprintf(fp, "Fragment has prev with text %s\n", fragment->prev->text);    
-}
-#endif
+const char* csplit_rfind_space(const char* begin, const char* current, int space);
 
+_CSPLIT_FUNC
+size_t csplit_compact_space(char* output, size_t out_cap, const char* data, size_t len);
 
-/**
- * @brief Function that returns the string fragment at a certain index in the list
- * @ingroup core
- * 
- * @params[in]: list    -> list generated by csplit
- * @params[in]: index   -> index to search for (can be negative for getting at index from back of list)
- * @return: text        -> string at the given index or NULL if index out of range.
- */
 _CSPLIT_FUNC
-char* csplit_get_fragment_at_index(CSplitList_t* list, int index){
-    // convert index into absolute index (if negative);
-    int target_index;
-    if(index < 0){
-        target_index = index + list->num_elems;
-    }
-    else{
-        target_index = index;
-    }
-    // if index is out of range return null
-    if(list->num_elems <= target_index || target_index < 0){
+CSplitError_t csplit_compile_charset(CSplitCharset_t* set, const char* chars);
+
+_CSPLIT_FUNC
+int csplit_charset_contains(const CSplitCharset_t* set, char c);
+
+_CSPLIT_FUNC
+void csplit_two_way_factorize(const unsigned char* needle, size_t len, ptrdiff_t step, int* periodic, size_t* critical_pos, size_t* period, size_t* shift);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_compile_token(CSplitToken_t* compiled, const char* token);
+
+_CSPLIT_FUNC
+const char* csplit_find_compiled(const CSplitToken_t* compiled, const char* haystack, size_t hay_len);
+
+_CSPLIT_FUNC
+const char* csplit_rfind_compiled(const CSplitToken_t* compiled, const char* haystack, size_t hay_len);
+
+_CSPLIT_FUNC
+const char* csplit_iter_find_byte(CSplitIter_t* iter);
+
+_CSPLIT_FUNC
+const char* csplit_iter_rfind_byte(CSplitIter_t* iter);
+
+_CSPLIT_FUNC
+void csplit_iter_setup(CSplitIter_t* iter, const char* input, size_t in_len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+void csplit_iter_setup_compiled(CSplitIter_t* iter, const char* input, size_t in_len, const CSplitToken_t* compiled, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+void csplit_iter_setup_charset(CSplitIter_t* iter, const char* input, size_t in_len, const CSplitCharset_t* set, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+void csplit_iter_setup_whitespace(CSplitIter_t* iter, const char* input, size_t in_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+int csplit_iter_next_whitespace(CSplitIter_t* iter, CSplitView_t* fragment);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_n(CSplitIter_t* iter, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init(CSplitIter_t* iter, const char* input_str, const char* token, int max_splits);
+
+_CSPLIT_FUNC
+int csplit_iter_next(CSplitIter_t* iter, CSplitView_t* fragment);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_foreach(const char* input_str, const char* token, int max_splits, CSplitCallback_t callback, void* user_data);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_charset(CSplitIter_t* iter, const char* input_str, const CSplitCharset_t* set, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_charset(CSplitList_t* list, const char* input_str, const CSplitCharset_t* set, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_charset(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const CSplitCharset_t* set, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_charset(CSplitArray_t* array, const char* input_str, const CSplitCharset_t* set, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_any(CSplitList_t* list, const char* input_str, const char* chars, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_whitespace(CSplitIter_t* iter, const char* input_str, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_whitespace(CSplitList_t* list, const char* input_str, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_whitespace(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_whitespace(CSplitArray_t* array, const char* input_str, int max_splits);
+
+_CSPLIT_FUNC
+unsigned int csplit_ctz64(uint64_t mask);
+
+_CSPLIT_FUNC
+uint64_t csplit_prefix_xor(uint64_t mask);
+
+_CSPLIT_FUNC
+void csplit_csv_classify(CSplitCsv_t* csv);
+
+_CSPLIT_FUNC
+size_t csplit_csv_next_structural(CSplitCsv_t* csv);
+
+_CSPLIT_FUNC
+size_t csplit_csv_unquote(char* output, const char* field, size_t len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_csv_init(CSplitCsv_t* csv, const char* data, size_t len, char delimiter);
+
+_CSPLIT_FUNC
+void csplit_csv_clear(CSplitCsv_t* csv);
+
+_CSPLIT_FUNC
+int csplit_csv_next(CSplitCsv_t* csv, CSplitView_t* fields, size_t max_fields, size_t* num_fields);
+
+_CSPLIT_FUNC
+uint64_t csplit_hash(const char* data, size_t len);
+
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_init_config(void);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_config_grow(CSplitConfig_t* config);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_config_set(CSplitConfig_t* config, const char* key, size_t key_len, const char* value, size_t value_len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_config_parse_line(CSplitConfig_t* config, const CSplitView_t* line, const char* separator, size_t separator_len);
+
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_load_config(const char* data, size_t len, const char* separator);
+
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_load_config_file(const char* path, const char* separator);
+
+_CSPLIT_FUNC
+const char* csplit_config_get_n(const CSplitConfig_t* config, const char* key, size_t key_len, size_t* value_len);
+
+_CSPLIT_FUNC
+const char* csplit_config_get(const CSplitConfig_t* config, const char* key);
+
+_CSPLIT_FUNC
+void csplit_clear_config(CSplitConfig_t* config);
+
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_init_batch(size_t num_inputs, size_t capacity);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_batch_push(CSplitBatch_t** batch, const char* text, size_t len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_batch_add(CSplitBatch_t** batch, size_t index, const char* input, size_t len, const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_batch(const char* const* inputs, size_t num_inputs, const char* token);
+
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_batch_n(const char* data, const size_t* offsets, size_t num_inputs, const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+const CSplitView_t* csplit_batch_get(const CSplitBatch_t* batch, size_t input, size_t* num_fragments);
+
+_CSPLIT_FUNC
+void csplit_clear_batch(CSplitBatch_t* batch);
+
+#ifdef CSPLIT_STATS
+_CSPLIT_FUNC
+CSplitStats_t csplit_get_stats(void);
+
+_CSPLIT_FUNC
+void csplit_reset_stats(void);
+
+_CSPLIT_FUNC
+void csplit_print_stats(const CSplitStats_t* stats, FILE* fp);
+
+_CSPLIT_FUNC
+void csplit_add_stats(CSplitStats_t* total, const CSplitStats_t* part);
+#endif
+
+_CSPLIT_FUNC
+void* csplit_malloc(size_t size);
+
+_CSPLIT_FUNC
+void* csplit_calloc(size_t num, size_t size);
+
+_CSPLIT_FUNC
+void* csplit_realloc(void* ptr, size_t size);
+
+_CSPLIT_FUNC
+void csplit_free(void* ptr);
+
+_CSPLIT_FUNC
+void* csplit_list_alloc(CSplitList_t* list, size_t size);
+
+_CSPLIT_FUNC
+void csplit_list_free(CSplitList_t* list, void* ptr, size_t size);
+
+_CSPLIT_FUNC
+CSplitList_t* csplit_init_allocator_list(const CSplitAllocator_t* allocator);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_count_n(const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits, size_t* num_fragments, size_t* total_bytes);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_count(const char* input_str, const char* token, int max_splits, size_t* num_fragments, size_t* total_bytes);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_fill_n(char** output, size_t out_size, size_t num_fragments, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_fill(char** output, size_t out_size, size_t num_fragments, const char* input_str, const char* token, int max_splits);
+
+_CSPLIT_FUNC
+int csplit_is_eight_digits(uint64_t chunk);
+
+_CSPLIT_FUNC
+uint32_t csplit_eight_digits(uint64_t chunk);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_to_int64(const char* text, size_t len, int64_t* value);
+
+_CSPLIT_FUNC
+int csplit_fast_double(const char* cur, const char* end, double* value);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_to_double(const char* text, size_t len, double* value);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_int64_n(int64_t* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* data, size_t len, const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_int64(int64_t* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_double_n(double* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* data, size_t len, const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_double(double* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitView_t csplit_field_n(const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t index);
+
+_CSPLIT_FUNC
+CSplitView_t csplit_field(const char* input_str, const char* token, int index);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_fields_n(CSplitView_t* fields, const size_t* indexes, size_t num_indexes, const char* data, size_t len, const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_fields(CSplitView_t* fields, const size_t* indexes, size_t num_indexes, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitFragment_t* csplit_new_fragment(CSplitList_t* list, const CSplitView_t* view);
+
+_CSPLIT_FUNC
+void csplit_insert_fragment(CSplitList_t* list, CSplitFragment_t* fragment, CSplitFragment_t* before);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_push_view_to_list(CSplitList_t* list, const CSplitView_t* view);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_list_from_iter(CSplitList_t* list, CSplitIter_t* iter);
+
+_CSPLIT_FUNC
+void csplit_reverse_views(CSplitView_t* views, size_t num_views);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_views_from_iter(CSplitView_t* views, size_t max_views, size_t* num_views, CSplitIter_t* iter);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_str(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_lim_n(CSplitView_t* views, size_t max_views, size_t* num_views, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_lim(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitError_t rcsplit_view(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitArray_t* csplit_init_array();
+
+_CSPLIT_FUNC
+void csplit_clear_array(CSplitArray_t* array);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_push_to_array(CSplitArray_t* array, const CSplitView_t* view);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_from_iter(CSplitArray_t* array, CSplitIter_t* iter);
+
+_CSPLIT_FUNC
+const CSplitView_t* csplit_get_view_at_index(CSplitArray_t* array, ptrdiff_t index);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_reverse_array(CSplitArray_t* array);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_lim_n(CSplitArray_t* array, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_lim(CSplitArray_t* array, const char* input_str, const char* token, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array(CSplitArray_t* array, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitError_t rcsplit_array(CSplitArray_t* array, const char* input_str, const char* token);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_compiled(CSplitList_t* list, const char* input_str, const CSplitToken_t* token, int max_splits);
+
+_CSPLIT_FUNC
+CSplitStream_t* csplit_init_stream(const char* token, size_t token_len);
+
+_CSPLIT_FUNC
+void csplit_clear_stream(CSplitStream_t* stream);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_stream_append(CSplitStream_t* stream, const char* bytes, size_t len);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_stream_feed(CSplitStream_t* stream, const char* chunk, size_t chunk_len);
+
+_CSPLIT_FUNC
+void csplit_stream_finish(CSplitStream_t* stream);
+
+_CSPLIT_FUNC
+int csplit_stream_join(CSplitStream_t* stream, CSplitView_t* fragment);
+
+_CSPLIT_FUNC
+int csplit_stream_next(CSplitStream_t* stream, CSplitView_t* fragment);
+
+_CSPLIT_FUNC
+CSplitFile_t* csplit_open_file(const char* path, const char* record_token);
+
+_CSPLIT_FUNC
+void csplit_close_file(CSplitFile_t* file);
+
+_CSPLIT_FUNC
+ptrdiff_t csplit_file_read_chunk(CSplitFile_t* file);
+
+_CSPLIT_FUNC
+int csplit_file_next_record(CSplitFile_t* file, CSplitView_t* record);
+
+_CSPLIT_FUNC
+int csplit_file_next(CSplitFile_t* file, CSplitView_t* fields, size_t max_fields, size_t* num_fields, const char* token, int max_splits);
+
+#ifdef CSPLIT_THREADS
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel_push_match(CSplitParallelChunk_t* chunk, size_t offset);
+
+_CSPLIT_FUNC
+void* csplit_parallel_find(void* arg);
+
+_CSPLIT_FUNC
+void* csplit_parallel_copy(void* arg);
+
+#ifdef CSPLIT_STATS
+_CSPLIT_FUNC
+void* csplit_parallel_worker(void* arg);
+#endif
+
+_CSPLIT_FUNC
+void csplit_parallel_run(CSplitParallelChunk_t* chunks, size_t num_chunks, void* (*work)(void*));
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel_stitch(CSplitParallelChunk_t* chunk, size_t next);
+
+_CSPLIT_FUNC
+size_t csplit_parallel_num_chunks(size_t len, int num_threads);
+
+_CSPLIT_FUNC
+CSplitParallelChunk_t* csplit_parallel_find_all(const char* data, size_t len, const char* token, size_t token_len, size_t num_chunks, size_t* num_fragments);
+
+_CSPLIT_FUNC
+void csplit_parallel_free(CSplitParallelChunk_t* chunks, size_t num_chunks);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len, int num_threads);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_parallel(CSplitArray_t* array, const char* data, size_t len, const char* token, size_t token_len, int num_threads);
+#endif
+
+_CSPLIT_FUNC
+CSplitError_t csplit_view_compiled(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const CSplitToken_t* token, int max_splits);
+
+_CSPLIT_FUNC
+CSplitError_t csplit_array_compiled(CSplitArray_t* array, const char* input_str, const CSplitToken_t* token, int max_splits);
+
+
+/* Function Definitions */
+
+
+/**
+ * @brief Function for initializing a csplit list
+ * @ingroup set
+ * 
+ * @params[in]: buff_size   -> user set buffer size. Make sure this is large enough for your largest fragment
+ * @return: list            -> an allocated csplit list
+ */
+_CSPLIT_FUNC
+CSplitList_t* csplit_init_list(){
+    return csplit_init_allocator_list(NULL);
+}
+
+
+/**
+ * @brief Function for initializing an arena backed csplit list. The list, its fragments, and their text
+ * are all allocated from one block of memory, which grows by adding blocks of double the size when full,
+ * so splitting performs almost no allocations, and clearing the list frees only the blocks.
+ * @ingroup set
+ *
+ * @params[in]: block_size  -> size of the first block in bytes, or 0 for CSPLIT_ARENA_BLOCK_SIZE
+ * @return: list            -> an allocated csplit list, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+CSplitList_t* csplit_init_arena_list(size_t block_size){
+    CSplitArenaBlock_t* block = csplit_new_arena(block_size, sizeof(CSplitList_t));
+    if(block == NULL)
+        return NULL;
+
+    // the list header itself is the first thing stored in the arena
+    CSplitList_t* list = (CSplitList_t*) (block + 1);
+    memset(list, 0, sizeof(CSplitList_t));
+    list->arena = block;
+    return list;
+}
+
+
+/**
+ * @brief Function that allocates the first block of an arena, with room reserved at its start for a header
+ * that owns the arena, such as an arena backed list.
+ * @ingroup intern
+ *
+ * @params[in]: block_size  -> size of the block in bytes, or 0 for CSPLIT_ARENA_BLOCK_SIZE
+ * @params[in]: header_size -> number of bytes reserved at the start of the block
+ * @return: block           -> the new block, whose header starts at block + 1, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+CSplitArenaBlock_t* csplit_new_arena(size_t block_size, size_t header_size){
+    header_size = (header_size + CSPLIT_ARENA_ALIGN - 1) & ~(CSPLIT_ARENA_ALIGN - 1);
+    if(block_size == 0)
+        block_size = CSPLIT_ARENA_BLOCK_SIZE;
+    if(block_size < header_size)
+        block_size = header_size;
+    CSplitArenaBlock_t* block = (CSplitArenaBlock_t*) csplit_malloc(sizeof(CSplitArenaBlock_t) + block_size);
+    if(block == NULL)
+        return NULL;
+    block->next = NULL;
+    block->size = block_size;
+    block->used = header_size;
+    return block;
+}
+
+
+/**
+ * @brief Function that allocates memory from an arena. A new block of at least double the size of the
+ * previous one is added if the current block is full.
+ * @ingroup intern
+ *
+ * @params[in/out]: arena   -> newest block of the arena, updated if a block is added
+ * @params[in]: size        -> number of bytes to allocate
+ * @return: ptr             -> uninitialized memory valid until the arena is freed, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+void* csplit_arena_push(CSplitArenaBlock_t** arena, size_t size){
+    CSplitArenaBlock_t* block = *arena;
+    void* ptr;
+    size = (size + CSPLIT_ARENA_ALIGN - 1) & ~(CSPLIT_ARENA_ALIGN - 1);
+    if(block->size - block->used < size){
+        size_t new_size = block->size * 2;
+        while(new_size < size)
+            new_size = new_size * 2;
+        CSplitArenaBlock_t* new_block = (CSplitArenaBlock_t*) csplit_malloc(sizeof(CSplitArenaBlock_t) + new_size);
+        if(new_block == NULL)
+            return NULL;
+        new_block->next = block;
+        new_block->size = new_size;
+        new_block->used = 0;
+        *arena = new_block;
+        block = new_block;
+    }
+    ptr = (char*) (block + 1) + block->used;
+    block->used = block->used + size;
+    return ptr;
+}
+
+
+/**
+ * @brief Function that frees every block of an arena, including the first one and the header stored in it
+ * @ingroup intern
+ *
+ * @params[in]: arena   -> newest block of the arena
+ */
+_CSPLIT_FUNC
+void csplit_free_arena(CSplitArenaBlock_t* arena){
+    while(arena != NULL){
+        CSplitArenaBlock_t* temp = arena->next;
+        csplit_free(arena);
+        arena = temp;
+    }
+}
+
+
+/**
+ * @brief Function that allocates memory from the arena of an arena backed list. A new block of at least
+ * double the size of the previous one is added if the current block is full.
+ * @ingroup intern
+ *
+ * @params[in]: list    -> list created with csplit_init_arena_list
+ * @params[in]: size    -> number of bytes to allocate
+ * @return: ptr         -> uninitialized memory valid until the list is cleared, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+void* csplit_arena_alloc(CSplitList_t* list, size_t size){
+    return csplit_arena_push(&list->arena, size);
+}
+
+
+/**
+ * @brief Clears all memory for an allocated csplit list
+ * @ingroup set
+ * 
+ * @params[in]: list    -> a previously allocated csplit list to be freed
+ */
+_CSPLIT_FUNC
+void csplit_clear_list(CSplitList_t* list){
+    // arena backed lists only need their blocks freed. The list itself lives in the first block.
+    if(list->arena != NULL){
+        csplit_free_arena(list->arena);
+        return;
+    }
+    csplit_free_fragments(list, list->head);
+    csplit_free_fragments(list, list->spare);
+    csplit_list_free(list, list, sizeof(CSplitList_t));
+}
+
+
+/**
+ * @brief Function that frees a chain of heap allocated fragments and their text, with the allocator of their list
+ * @ingroup intern
+ *
+ * @params[in]: list        -> list that allocated the fragments
+ * @params[in]: fragment    -> first fragment of the chain, linked by next
+ */
+_CSPLIT_FUNC
+void csplit_free_fragments(CSplitList_t* list, CSplitFragment_t* fragment){
+    while(fragment != NULL){
+        CSplitFragment_t* temp = fragment->next;
+        csplit_list_free(list, fragment->text, fragment->text_cap);
+        csplit_list_free(list, fragment, sizeof(CSplitFragment_t));
+        fragment = temp;
+    }
+}
+
+
+/**
+ * @brief Function that empties a csplit list so it can be split into again, keeping its memory. The fragments
+ * of a heap list are kept with their text buffers, and reused in order by the next splits, so splitting inputs
+ * of about the same shape again and again allocates nothing. The blocks of an arena backed list are merged
+ * into one, which the next splits fill before allocating. With shrink set, the kept memory is freed instead.
+ * @ingroup set
+ *
+ * @params[in]: list    -> list to empty
+ * @params[in]: shrink  -> nonzero to free the memory of the old fragments instead of keeping it
+ */
+_CSPLIT_FUNC
+void csplit_reset_list(CSplitList_t* list, int shrink){
+    if(list == NULL)
+        return;
+    if(list->arena != NULL){
+        // the first block holds the list itself. Any others are merged into a single block as large as all
+        // of them, so the next split of the same input fits without allocating.
+        CSplitArenaBlock_t* block = list->arena;
+        CSplitArenaBlock_t* prev = NULL;
+        size_t total_size = 0;
+        int num_blocks = 0;
+        while(block->next != NULL){
+            total_size = total_size + block->size;
+            num_blocks++;
+            prev = block;
+            block = block->next;
+        }
+        block->used = (sizeof(CSplitList_t) + CSPLIT_ARENA_ALIGN - 1) & ~(CSPLIT_ARENA_ALIGN - 1);
+        if(num_blocks == 1 && !shrink){
+            list->arena->used = 0;
+        }
+        else if(num_blocks > 0){
+            CSplitArenaBlock_t* first = block;
+            prev->next = NULL;
+            csplit_free_arena(list->arena);
+            list->arena = first;
+            block = shrink ? NULL : (CSplitArenaBlock_t*) csplit_malloc(sizeof(CSplitArenaBlock_t) + total_size);
+            if(block != NULL){
+                block->next = first;
+                block->size = total_size;
+                block->used = 0;
+                list->arena = block;
+            }
+        }
+    }
+    else if(shrink){
+        csplit_free_fragments(list, list->head);
+        csplit_free_fragments(list, list->spare);
+        list->spare = NULL;
+    }
+    else if(list->head != NULL){
+        // the fragments already link to each other in order, so they become the front of the spares
+        list->tail->next = list->spare;
+        list->spare = list->head;
+    }
+    list->head = NULL;
+    list->tail = NULL;
+    list->num_elems = 0;
+}
+
+
+/**
+ * @brief Function that links a fragment to the end of the list, without allocating anything
+ * @ingroup intern
+ *
+ * @params[out]: list       -> The list with fragment appended to the tail
+ * @params[in]: fragment    -> fragment to append to the list
+ */
+_CSPLIT_FUNC
+void csplit_append_fragment(CSplitList_t* list, CSplitFragment_t* fragment){
+    // update the number of elements, and the pointers
+    list->num_elems = list->num_elems + 1;
+    if(list->head == NULL){
+        list->head = fragment;
+        list->tail = fragment;
+    }
+    else{
+        list->tail->next = fragment;
+        fragment->prev = list->tail;
+        list->tail = fragment;
+    }
+}
+
+
+/**
+ * @brief Function that pushes a new CSplitFragment to the end of the list, and allocates buff_size bytes for its text.
+ * For heap lists the fragment must have been allocated with the list's allocator, and belongs to the list from then on.
+ * For arena backed lists the text is allocated from the arena, but the fragment itself stays owned by the caller:
+ * csplit_clear_list and csplit_reset_list never free it, so the caller must free it after either of them.
+ * @ingroup intern
+ * 
+ * @params[out]: list       -> The list with fragment appended to the tail
+ * @params[in]: fragment    -> fragment to append to the list, whose text is allocated with buff_size bytes. Freed by
+ *                             the list unless the list is arena backed, in which case the caller keeps ownership
+ * @params[in]: buff_size   -> number of bytes to allocate for fragment->text
+ * @return: err             -> CSPLIT_TOO_SHORT if list or fragment is NULL
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_push_to_list(CSplitList_t* list, CSplitFragment_t* fragment, size_t buff_size){
+    // first make sure neither is null
+    if(list == NULL || fragment == NULL){
+        return CSPLIT_TOO_SHORT;
+    }
+    else{
+        csplit_append_fragment(list, fragment);
+        // allocate fragment text field
+        if(list->arena != NULL){
+            fragment->text = (char*) csplit_arena_alloc(list, buff_size);
+            if(fragment->text != NULL)
+                memset(fragment->text, 0, buff_size);
+        }
+        else{
+            fragment->text = (char*) csplit_list_alloc(list, buff_size);
+            if(fragment->text != NULL)
+                memset(fragment->text, 0, buff_size);
+            fragment->text_cap = buff_size;
+        }
+    }
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that prints information about a csplit list
+ * @ingroup set
+ * 
+ * @params[in]: list    -> list for which to print info
+ * @params[in]: fp      -> file pointer to print into.
+ */
+_CSPLIT_FUNC
+void csplit_print_list_info(CSplitList_t* list, FILE* fp){
+    if(list == NULL || fp == NULL) return;
+    fprintf(fp, "List contains %d elements\n", list->num_elems);
+    fprintf(fp, "Supports indexes -%d to %d.\n", list->num_elems, list->num_elems -1);
+    CSplitFragment_t* current_fragment = list->head;
+    while(current_fragment != NULL){
+        fprintf(fp, "--%s--\n", current_fragment->text);
+        current_fragment = current_fragment->next;
+    }
+}
+
+
+#ifdef CSPLIT_DEBUG
+/**
+ * @brief Function that prints information about a csplit fragment - intended for internal use only
+ * @ingroup intern
+ * 
+ * @params[in]: fragment    -> fragment for which to print info
+ * @params[in]: fp          -> file pointer to print into
+ */
+_CSPLIT_FUNC
+void print_csplit_fragment_info(CSplitFragment_t* fragment, FILE* fp){
+    if(fragment == NULL || fp == NULL) return;
+    fprintf(fp, "Fragment has text %s\n", fragment->text);
+    if(fragment->next != NULL) fprintf(fp, "Fragment has next with text %s\n", fragment->next->text);
+    if(fragment->prev != NULL) fprintf(fp, "Fragment has prev with text %s\n", fragment->prev->text);    
+}
+#endif
+
+
+/**
+ * @brief Function that returns the string fragment at a certain index in the list
+ * @ingroup core
+ * 
+ * @params[in]: list    -> list generated by csplit
+ * @params[in]: index   -> index to search for (can be negative for getting at index from back of list)
+ * @return: text        -> string at the given index or NULL if index out of range.
+ */
+_CSPLIT_FUNC
+char* csplit_get_fragment_at_index(CSplitList_t* list, int index){
+    // convert index into absolute index (if negative);
+    int target_index;
+    if(index < 0){
+        target_index = index + list->num_elems;
+    }
+    else{
+        target_index = index;
+    }
+    // if index is out of range return null
+    if(list->num_elems <= target_index || target_index < 0){
+        return NULL;
+    }
+    else if(target_index >= list->num_elems / 2){
+        // index is in the back half, so walk backwards from the tail
+        int counter = list->num_elems - 1;
+        CSplitFragment_t* current_fragment = list->tail;
+        while(counter > target_index){
+            current_fragment = current_fragment->prev;
+            counter--;
+        }
+        return current_fragment->text;
+    }
+    else{
+        // iterate over list until index found
+        int counter = 0;
+        CSplitFragment_t* current_fragment = list->head;
+        while(counter < target_index){
+            current_fragment = current_fragment->next;
+            counter++;
+        }
+        // return the text field
+        return current_fragment->text;
+    }
+}
+
+
+/**
+ * @brief Function that reverses the list generated by csplit
+ * @ingroup set
+ * 
+ * @params[out]: list   -> list to reverse
+ * @return: err         -> error code if there is an error
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_reverse_list(CSplitList_t* list){
+    int i;
+    // iterate over list and swap next and previous fields
+    CSplitFragment_t* temp = list->head;
+    for(i = 0; i < list->num_elems; i++){
+        CSplitFragment_t* temp2 = temp->next;
+        temp->next = temp->prev;
+        temp->prev = temp2;
+        temp = temp2;
+    }
+    // swap head and tail
+    temp = list->head;
+    list->head = list->tail;
+    list->tail = temp;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that strips a given string into an output string. Will remove whitespace character:
+ * \n, \r, \t, space will be removed from the start and end of each string.
+ * @ingroup core
+ * 
+ * @params[in]: input_str   -> the input string to strip
+ * @return: output_str      -> the string with whitespace removed from the ends. Must be freed.
+ */
+_CSPLIT_FUNC
+char* csplit_strip(char* input_str){
+    if(input_str == NULL)
+        return NULL;
+    return csplit_strip_n(input_str, strlen(input_str), NULL);
+}
+
+
+/**
+ * @brief Version of csplit_strip for input of known length, which may contain NUL characters.
+ * Note that resulting char* must be free'd after it is no longer used
+ * @ingroup core
+ *
+ * @params[in]: data        -> input to strip
+ * @params[in]: len         -> number of bytes in data
+ * @params[out]: out_len    -> if not NULL, receives the length of the stripped string
+ * @return: output_str      -> NUL terminated copy of data without leading/trailing whitespace, or NULL if data is all whitespace
+ */
+_CSPLIT_FUNC
+char* csplit_strip_n(const char* data, size_t len, size_t* out_len){
+    char* output_str;
+    if(data == NULL)
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_STRIP);
+    CSplitView_t stripped = csplit_strip_view(data, len);
+    // input consisting only of whitespace has nothing left to return
+    if(stripped.len == 0 && len > 0)
+        return NULL;
+
+    output_str = (char*) csplit_malloc(stripped.len + 1);
+    if(output_str == NULL)
+        return NULL;
+    memcpy(output_str, stripped.text, stripped.len);
+    output_str[stripped.len] = '\0';
+    CSPLIT_STAT_ADD(bytes_copied, stripped.len);
+    if(out_len != NULL)
+        *out_len = stripped.len;
+    return output_str;
+}
+
+
+/**
+ * @brief Version of csplit_strip that allocates nothing, returning a view of the stripped part of the input.
+ * @ingroup core
+ *
+ * @params[in]: data        -> input to strip
+ * @params[in]: len         -> number of bytes in data
+ * @return: view            -> view into data without leading/trailing whitespace. Empty if data is all whitespace
+ */
+_CSPLIT_FUNC
+CSplitView_t csplit_strip_view(const char* data, size_t len){
+    CSplitView_t stripped;
+    const char* start = data;
+    const char* end = data + len;
+    if(data == NULL){
+        stripped.text = NULL;
+        stripped.len = 0;
+        return stripped;
+    }
+    while(start != end && csplit_is_space(*start))
+        start++;
+    while(end != start && csplit_is_space(end[-1]))
+        end--;
+    stripped.text = start;
+    stripped.len = (size_t) (end - start);
+    return stripped;
+}
+
+
+/**
+ * @brief Version of csplit_strip that strips a caller owned string in place. The byte after the last non whitespace
+ * character is set to NUL, and a pointer to the first one is returned. Nothing is moved, so the original pointer is
+ * still the one to free.
+ * @ingroup core
+ *
+ * @params[in/out]: input_str   -> string to strip
+ * @return: output_str          -> pointer into input_str to the stripped string, which is empty if it was all whitespace
+ */
+_CSPLIT_FUNC
+char* csplit_strip_inplace(char* input_str){
+    if(input_str == NULL)
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_STRIP);
+    CSplitView_t stripped = csplit_strip_view(input_str, strlen(input_str));
+    char* output_str = input_str + (stripped.text - input_str);
+    output_str[stripped.len] = '\0';
+    return output_str;
+}
+
+
+/**
+ * @brief Version of csplit_strip_n that writes the NUL terminated result to a caller supplied buffer
+ * @ingroup core
+ *
+ * @params[out]: output_str -> buffer receiving the stripped string
+ * @params[in]: out_size    -> size of output_str in bytes, including room for the NUL terminator
+ * @params[in]: data        -> input to strip. May be output_str itself.
+ * @params[in]: len         -> number of bytes in data
+ * @params[out]: out_len    -> if not NULL, receives the length of the stripped string
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if output_str is too small, in which case it is left unchanged
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_strip_into(char* output_str, size_t out_size, const char* data, size_t len, size_t* out_len){
+    if(output_str == NULL || data == NULL)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_STRIP);
+    CSplitView_t stripped = csplit_strip_view(data, len);
+    if(stripped.len >= out_size)
+        return CSPLIT_BUFF_EXCEEDED;
+    memmove(output_str, stripped.text, stripped.len);
+    CSPLIT_STAT_ADD(bytes_copied, stripped.len);
+    output_str[stripped.len] = '\0';
+    if(out_len != NULL)
+        *out_len = stripped.len;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @breifFunction that removes all whitespace characters of a given string into an output string.
+ * Note that resulting char* must be free'd after it is no longer used
+ * @ingroup core
+ * 
+ * @params[in]: input_str   -> the input string to strip
+ * @return: output_str      -> the string with whitespace removed.
+ */
+_CSPLIT_FUNC
+char* csplit_remove_whitespace(char* input_str){
+    char* output_str;
+    if(input_str == NULL)
+        output_str = NULL;
+    else{
+        size_t len = strlen(input_str);
+        output_str = (char*) csplit_malloc(len + 1);
+        if(output_str == NULL)
+            return NULL;
+        // read through but don't copy whitespace
+        output_str[csplit_compact_space(output_str, len, input_str, len)] = '\0';
+    }
+    return output_str;
+}
+
+
+/**
+ * @brief Version of csplit_remove_whitespace that compacts a caller owned string in place
+ * @ingroup core
+ *
+ * @params[in/out]: input_str   -> string to remove whitespace from
+ * @return: len                 -> length of the string with whitespace removed, 0 if input_str is NULL
+ */
+_CSPLIT_FUNC
+size_t csplit_remove_whitespace_inplace(char* input_str){
+    size_t len;
+    if(input_str == NULL)
+        return 0;
+    len = strlen(input_str);
+    len = csplit_compact_space(input_str, len, input_str, len);
+    input_str[len] = '\0';
+    return len;
+}
+
+
+/**
+ * @brief Version of csplit_remove_whitespace for input of known length, writing the NUL terminated result to a
+ * caller supplied buffer
+ * @ingroup core
+ *
+ * @params[out]: output_str -> buffer receiving the string with whitespace removed
+ * @params[in]: out_size    -> size of output_str in bytes, including room for the NUL terminator
+ * @params[in]: data        -> input to remove whitespace from. May be output_str itself.
+ * @params[in]: len         -> number of bytes in data
+ * @params[out]: out_len    -> if not NULL, receives the length of the result
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if output_str is too small, in which case its contents are unspecified
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_remove_whitespace_into(char* output_str, size_t out_size, const char* data, size_t len, size_t* out_len){
+    if(output_str == NULL || data == NULL || out_size == 0)
+        return CSPLIT_TOO_SHORT;
+    size_t count = csplit_compact_space(output_str, out_size - 1, data, len);
+    if(count >= out_size)
+        return CSPLIT_BUFF_EXCEEDED;
+    output_str[count] = '\0';
+    if(out_len != NULL)
+        *out_len = count;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that checks if a given string starts with another given string.
+ * @ingroup core
+ * 
+ * @params[in]: input_str       -> string to check against
+ * @params[in]: starts_with     -> string to try to match with start of input string
+ * @return:     int             -> -2 if input is invalid, -1 if doesn't start with given string, or 0 if it does
+ */
+_CSPLIT_FUNC
+int csplit_startswith(char* input_str, char* starts_with){
+    if(input_str == NULL || starts_with == NULL) return -2;
+    // strncmp stops at the end of input_str, so only the prefix is ever compared
+    else if(strncmp(input_str, starts_with, strlen(starts_with)) == 0) return 0;
+    else return -1;
+}
+
+
+/**
+ * @brief Version of csplit_startswith for input and prefix of known length, which may contain NUL characters.
+ * @ingroup core
+ *
+ * @params[in]: data            -> input to check against
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: prefix          -> bytes to try to match with start of data
+ * @params[in]: prefix_len      -> number of bytes in prefix
+ * @return:     int             -> -2 if input is invalid, -1 if doesn't start with prefix, or 0 if it does
+ */
+_CSPLIT_FUNC
+int csplit_startswith_n(const char* data, size_t len, const char* prefix, size_t prefix_len){
+    if(data == NULL || prefix == NULL) return -2;
+    else if(prefix_len > len) return -1;
+    else if(memcmp(data, prefix, prefix_len) == 0) return 0;
+    else return -1;
+}
+
+
+/**
+ * @brief Function that checks if a given string ends with another given string.
+ * @ingroup core
+ * 
+ * @params[in]: input_str       -> string to check against
+ * @params[in]: ends_with       -> string to try to match with end of input string
+ * @return:     int             -> -2 if input is invalid, -1 if doesn't end with given string, or 0 if it does
+ */
+_CSPLIT_FUNC
+int csplit_endswith(char* input_str, char* ends_with){
+    if(input_str == NULL || ends_with == NULL){
+        return -2;
+    }
+    else
+        return csplit_endswith_n(input_str, strlen(input_str), ends_with, strlen(ends_with));
+}
+
+
+/**
+ * @brief Version of csplit_endswith for input and suffix of known length, which may contain NUL characters.
+ * @ingroup core
+ *
+ * @params[in]: data            -> input to check against
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: suffix          -> bytes to try to match with end of data
+ * @params[in]: suffix_len      -> number of bytes in suffix
+ * @return:     int             -> -2 if input is invalid, -1 if doesn't end with suffix, or 0 if it does
+ */
+_CSPLIT_FUNC
+int csplit_endswith_n(const char* data, size_t len, const char* suffix, size_t suffix_len){
+    if(data == NULL || suffix == NULL) return -2;
+    else if(suffix_len > len) return -1;
+    else if(memcmp(data + len - suffix_len, suffix, suffix_len) == 0) return 0;
+    else return -1;
+}
+
+
+/**
+ * @brief Function that finds the first occurrence of a token in a buffer of known length
+ * @ingroup intern
+ *
+ * @params[in]: haystack    -> buffer to search
+ * @params[in]: hay_len     -> length of the buffer in bytes
+ * @params[in]: token       -> token to search for
+ * @params[in]: token_len   -> length of the token in bytes
+ * @return: location        -> pointer to the first match, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_find_token(const char* haystack, size_t hay_len, const char* token, size_t token_len){
+    if(token_len == 0 || token_len > hay_len) return NULL;
+    const char* last = haystack + hay_len - token_len;
+    const char* current = haystack;
+#ifdef CSPLIT_SIMD_WIDTH
+    // check the first and last token bytes at a block of positions at once, and only compare
+    // the middle of the token where both match. Stops while every load is still in bounds.
+    if(token_len > 1){
+        while(current <= last && (size_t) (last - current) >= CSPLIT_SIMD_WIDTH - 1){
+            uint32_t mask = csplit_pair_mask(current, token_len - 1, token[0], token[token_len - 1]);
+            while(mask != 0){
+                const char* candidate = current + csplit_ctz(mask);
+                if(memcmp(candidate + 1, token + 1, token_len - 2) == 0) return candidate;
+                mask = mask & (mask - 1);
+            }
+            current = current + CSPLIT_SIMD_WIDTH;
+        }
+    }
+#endif
+    // jump between occurrences of the first token byte, and compare the rest
+    while(current <= last){
+        current = (const char*) memchr(current, token[0], last - current + 1);
+        if(current == NULL) return NULL;
+        if(memcmp(current + 1, token + 1, token_len - 1) == 0) return current;
+        current++;
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Function that finds the last occurrence of a token in a buffer of known length
+ * @ingroup intern
+ *
+ * @params[in]: haystack    -> buffer to search
+ * @params[in]: hay_len     -> length of the buffer in bytes
+ * @params[in]: token       -> token to search for
+ * @params[in]: token_len   -> length of the token in bytes
+ * @return: location        -> pointer to the last match, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_rfind_token(const char* haystack, size_t hay_len, const char* token, size_t token_len){
+    if(token_len == 0 || token_len > hay_len) return NULL;
+    // offset of the last position the token could start at
+    size_t current = hay_len - token_len;
+#ifdef CSPLIT_SIMD_WIDTH
+    // filter a block of positions on the first and last token bytes at once, checking candidates
+    // from the highest position down. Stops while every load is still in bounds.
+    if(token_len > 1){
+        while(current + 1 >= CSPLIT_SIMD_WIDTH){
+            size_t block = current + 1 - CSPLIT_SIMD_WIDTH;
+            uint32_t mask = csplit_pair_mask(haystack + block, token_len - 1, token[0], token[token_len - 1]);
+            while(mask != 0){
+                unsigned int index = csplit_last_bit(mask);
+                if(memcmp(haystack + block + index + 1, token + 1, token_len - 2) == 0) return haystack + block + index;
+                mask = mask & ~((uint32_t) 1 << index);
+            }
+            if(block == 0) return NULL;
+            current = block - 1;
+        }
+    }
+#endif
+    while(1){
+        if(haystack[current] == token[0] && memcmp(haystack + current + 1, token + 1, token_len - 1) == 0) return haystack + current;
+        if(current == 0) return NULL;
+        current--;
+    }
+}
+
+
+#ifdef CSPLIT_SIMD_WIDTH
+/**
+ * @brief Function that returns the index of the lowest set bit of a nonzero mask
+ * @ingroup intern
+ *
+ * @params[in]: mask    -> nonzero bitmask
+ * @return: index       -> index of the lowest set bit
+ */
+_CSPLIT_FUNC
+unsigned int csplit_ctz(uint32_t mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned int) index;
+#else
+    return (unsigned int) __builtin_ctz(mask);
+#endif
+}
+
+
+/**
+ * @brief Function that returns the index of the highest set bit of a nonzero mask
+ * @ingroup intern
+ *
+ * @params[in]: mask    -> nonzero bitmask
+ * @return: index       -> index of the highest set bit
+ */
+_CSPLIT_FUNC
+unsigned int csplit_last_bit(uint32_t mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (unsigned int) index;
+#else
+    return 31 - (unsigned int) __builtin_clz(mask);
+#endif
+}
+
+
+/**
+ * @brief Function that counts the set bits of a mask
+ * @ingroup intern
+ *
+ * @params[in]: mask    -> bitmask
+ * @return: count       -> number of set bits
+ */
+_CSPLIT_FUNC
+unsigned int csplit_popcount(uint64_t mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+    mask = mask - ((mask >> 1) & 0x5555555555555555ULL);
+    mask = (mask & 0x3333333333333333ULL) + ((mask >> 2) & 0x3333333333333333ULL);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (unsigned int) ((mask * 0x0101010101010101ULL) >> 56);
+#else
+    return (unsigned int) __builtin_popcountll(mask);
+#endif
+}
+
+
+/**
+ * @brief Function that compares a block of up to CSPLIT_SIMD_WIDTH bytes against a byte with SIMD
+ * @ingroup intern
+ *
+ * @params[in]: block   -> start of the block
+ * @params[in]: len     -> number of bytes in the block, at most CSPLIT_SIMD_WIDTH
+ * @params[in]: byte    -> byte to search for
+ * @return: mask        -> bitmask with bit i set if block[i] == byte
+ */
+_CSPLIT_FUNC
+uint32_t csplit_byte_mask(const char* block, size_t len, char byte){
+    uint32_t mask;
+    char tail[CSPLIT_SIMD_WIDTH];
+    // never read past the end of the input, copy a partial block into a padded buffer
+    if(len < CSPLIT_SIMD_WIDTH){
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, block, len);
+        block = tail;
+    }
+#ifdef CSPLIT_AVX2
+    __m256i data = _mm256_loadu_si256((const __m256i*) block);
+    mask = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(byte)));
+#else
+    __m128i data = _mm_loadu_si128((const __m128i*) block);
+    mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(byte)));
+#endif
+    if(len < CSPLIT_SIMD_WIDTH)
+        mask = mask & ((1u << len) - 1);
+    return mask;
+}
+
+
+/**
+ * @brief Function that finds the positions in a block where a token could start, by comparing its first
+ * and last bytes against CSPLIT_SIMD_WIDTH positions at once
+ * @ingroup intern
+ *
+ * @params[in]: block   -> start of the block. CSPLIT_SIMD_WIDTH + offset bytes must be readable
+ * @params[in]: offset  -> distance between the first and last bytes of the token
+ * @params[in]: first   -> first byte of the token
+ * @params[in]: last    -> last byte of the token
+ * @return: mask        -> bitmask with bit i set if block[i] == first and block[i + offset] == last
+ */
+_CSPLIT_FUNC
+uint32_t csplit_pair_mask(const char* block, size_t offset, char first, char last){
+#ifdef CSPLIT_AVX2
+    __m256i start = _mm256_loadu_si256((const __m256i*) block);
+    __m256i end = _mm256_loadu_si256((const __m256i*) (block + offset));
+    __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(start, _mm256_set1_epi8(first)),
+                                  _mm256_cmpeq_epi8(end, _mm256_set1_epi8(last)));
+    return (uint32_t) _mm256_movemask_epi8(eq);
+#else
+    __m128i start = _mm_loadu_si128((const __m128i*) block);
+    __m128i end = _mm_loadu_si128((const __m128i*) (block + offset));
+    __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(start, _mm_set1_epi8(first)),
+                               _mm_cmpeq_epi8(end, _mm_set1_epi8(last)));
+    return (uint32_t) _mm_movemask_epi8(eq);
+#endif
+}
+
+
+/**
+ * @brief Function that finds the bytes of a block of up to CSPLIT_SIMD_WIDTH bytes that are in a set. Each byte is
+ * split into nibbles, which index lookup tables with a byte shuffle, and the byte is in the set if the two looked
+ * up values share a bit. Without SSSE3 the block is compared against every byte of a small set instead.
+ * @ingroup intern
+ *
+ * @params[in]: set     -> set compiled with csplit_compile_charset
+ * @params[in]: block   -> start of the block
+ * @params[in]: len     -> number of bytes in the block, at most CSPLIT_SIMD_WIDTH
+ * @return: mask        -> bitmask with bit i set if block[i] is in the set
+ */
+_CSPLIT_FUNC
+uint32_t csplit_charset_mask(const CSplitCharset_t* set, const char* block, size_t len){
+    uint32_t mask = 0;
+    char tail[CSPLIT_SIMD_WIDTH];
+    // never read past the end of the input, copy a partial block into a padded buffer
+    if(len < CSPLIT_SIMD_WIDTH){
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, block, len);
+        block = tail;
+    }
+#ifdef CSPLIT_AVX2
+    __m256i data = _mm256_loadu_si256((const __m256i*) block);
+    __m256i low = _mm256_and_si256(data, _mm256_set1_epi8(0x0F));
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(data, 4), _mm256_set1_epi8(0x0F));
+    __m256i high_bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                         1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->lo_table));
+    __m256i found = _mm256_and_si256(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(high_bits, high));
+    if(set->has_high){
+        high_bits = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128,
+                                     0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+        table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) set->lo_table_high));
+        found = _mm256_or_si256(found, _mm256_and_si256(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(high_bits, high)));
+    }
+    mask = ~(uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(found, _mm256_setzero_si256()));
+#elif defined(CSPLIT_SSSE3)
+    __m128i data = _mm_loadu_si128((const __m128i*) block);
+    __m128i low = _mm_and_si128(data, _mm_set1_epi8(0x0F));
+    __m128i high = _mm_and_si128(_mm_srli_epi16(data, 4), _mm_set1_epi8(0x0F));
+    __m128i high_bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i table = _mm_loadu_si128((const __m128i*) set->lo_table);
+    __m128i found = _mm_and_si128(_mm_shuffle_epi8(table, low), _mm_shuffle_epi8(high_bits, high));
+    if(set->has_high){
+        high_bits = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+        table = _mm_loadu_si128((const __m128i*) set->lo_table_high);
+        found = _mm_or_si128(found, _mm_and_si128(_mm_shuffle_epi8(table, low), _mm_shuffle_epi8(high_bits, high)));
+    }
+    mask = ~(uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(found, _mm_setzero_si128())) & 0xFFFF;
+#else
+    if(set->num_members <= sizeof(set->members)){
+        __m128i data = _mm_loadu_si128((const __m128i*) block);
+        __m128i found = _mm_setzero_si128();
+        size_t i;
+        for(i = 0; i < set->num_members; i++)
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(data, _mm_set1_epi8(set->members[i])));
+        mask = (uint32_t) _mm_movemask_epi8(found);
+    }
+    else{
+        size_t i;
+        for(i = 0; i < CSPLIT_SIMD_WIDTH; i++)
+            mask = mask | ((uint32_t) csplit_charset_contains(set, block[i]) << i);
+    }
+#endif
+    if(len < CSPLIT_SIMD_WIDTH)
+        mask = mask & ((1u << len) - 1);
+    return mask;
+}
+
+
+/**
+ * @brief Function that finds the whitespace bytes of a block of up to CSPLIT_SIMD_WIDTH bytes. A byte is whitespace
+ * if it is a space, or if subtracting '\t' leaves at most 4, which covers '\t', '\n', '\v', '\f' and '\r'.
+ * @ingroup intern
+ *
+ * @params[in]: block   -> start of the block
+ * @params[in]: len     -> number of bytes in the block, at most CSPLIT_SIMD_WIDTH
+ * @return: mask        -> bitmask with bit i set if block[i] is whitespace
+ */
+_CSPLIT_FUNC
+uint32_t csplit_space_mask(const char* block, size_t len){
+    uint32_t mask;
+    char tail[CSPLIT_SIMD_WIDTH];
+    // never read past the end of the input, copy a partial block into a padded buffer
+    if(len < CSPLIT_SIMD_WIDTH){
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, block, len);
+        block = tail;
+    }
+#ifdef CSPLIT_AVX2
+    __m256i data = _mm256_loadu_si256((const __m256i*) block);
+    __m256i control = _mm256_sub_epi8(data, _mm256_set1_epi8('\t'));
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(' ')),
+                                    _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control));
+    mask = (uint32_t) _mm256_movemask_epi8(space);
+#else
+    __m128i data = _mm_loadu_si128((const __m128i*) block);
+    __m128i control = _mm_sub_epi8(data, _mm_set1_epi8('\t'));
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(' ')),
+                                 _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control));
+    mask = (uint32_t) _mm_movemask_epi8(space);
+#endif
+    if(len < CSPLIT_SIMD_WIDTH)
+        mask = mask & ((1u << len) - 1);
+    return mask;
+}
+#endif
+
+
+/**
+ * @brief Function that checks if a byte is ASCII whitespace: ' ', '\t', '\n', '\v', '\f' or '\r'. Unlike isspace,
+ * it does not depend on the locale.
+ * @ingroup intern
+ *
+ * @params[in]: c       -> byte to check
+ * @return: int         -> 1 if c is whitespace, 0 otherwise
+ */
+_CSPLIT_FUNC
+int csplit_is_space(char c){
+    return c == ' ' || (unsigned char) (c - '\t') <= 4;
+}
+
+
+/**
+ * @brief Function that finds the first byte that is whitespace, or the first one that is not
+ * @ingroup intern
+ *
+ * @params[in]: current -> where to start searching
+ * @params[in]: end     -> end of the input
+ * @params[in]: space   -> nonzero to find whitespace, zero to find anything else
+ * @return: location    -> pointer to the byte found, or end if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_find_space(const char* current, const char* end, int space){
+#ifdef CSPLIT_SIMD_WIDTH
+    while(current < end){
+        size_t block_len = (size_t) (end - current);
+        if(block_len > CSPLIT_SIMD_WIDTH)
+            block_len = CSPLIT_SIMD_WIDTH;
+        uint32_t mask = csplit_space_mask(current, block_len);
+        if(!space)
+            mask = ~mask & (uint32_t) (((uint64_t) 1 << block_len) - 1);
+        if(mask != 0)
+            return current + csplit_ctz(mask);
+        current = current + block_len;
+    }
+    return end;
+#else
+    while(current < end && csplit_is_space(*current) != !!space)
+        current++;
+    return current;
+#endif
+}
+
+
+/**
+ * @brief Function that finds the last byte before a position that is whitespace, or the last one that is not
+ * @ingroup intern
+ *
+ * @params[in]: begin   -> start of the input
+ * @params[in]: current -> position before which to search
+ * @params[in]: space   -> nonzero to find whitespace, zero to find anything else
+ * @return: location    -> pointer to the byte found, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_rfind_space(const char* begin, const char* current, int space){
+#ifdef CSPLIT_SIMD_WIDTH
+    while(current > begin){
+        size_t block_len = (size_t) (current - begin);
+        if(block_len > CSPLIT_SIMD_WIDTH)
+            block_len = CSPLIT_SIMD_WIDTH;
+        current = current - block_len;
+        uint32_t mask = csplit_space_mask(current, block_len);
+        if(!space)
+            mask = ~mask & (uint32_t) (((uint64_t) 1 << block_len) - 1);
+        if(mask != 0)
+            return current + csplit_last_bit(mask);
+    }
+    return NULL;
+#else
+    while(current > begin){
+        current--;
+        if(csplit_is_space(*current) == !!space)
+            return current;
+    }
+    return NULL;
+#endif
+}
+
+
+#if defined(CSPLIT_SSSE3) || defined(CSPLIT_AVX2)
+/**
+ * @brief Byte shuffles that move the bytes of an 8 byte group whose bit is clear in the index to the front,
+ * in order. Used by csplit_compact_space to drop the whitespace of a group with one shuffle.
+ * @ingroup intern
+ */
+static const uint64_t csplit_compact_table[256] = {
+    0x0706050403020100ULL, 0x8007060504030201ULL, 0x8007060504030200ULL, 0x8080070605040302ULL,
+    0x8007060504030100ULL, 0x8080070605040301ULL, 0x8080070605040300ULL, 0x8080800706050403ULL,
+    0x8007060504020100ULL, 0x8080070605040201ULL, 0x8080070605040200ULL, 0x8080800706050402ULL,
+    0x8080070605040100ULL, 0x8080800706050401ULL, 0x8080800706050400ULL, 0x8080808007060504ULL,
+    0x8007060503020100ULL, 0x8080070605030201ULL, 0x8080070605030200ULL, 0x8080800706050302ULL,
+    0x8080070605030100ULL, 0x8080800706050301ULL, 0x8080800706050300ULL, 0x8080808007060503ULL,
+    0x8080070605020100ULL, 0x8080800706050201ULL, 0x8080800706050200ULL, 0x8080808007060502ULL,
+    0x8080800706050100ULL, 0x8080808007060501ULL, 0x8080808007060500ULL, 0x8080808080070605ULL,
+    0x8007060403020100ULL, 0x8080070604030201ULL, 0x8080070604030200ULL, 0x8080800706040302ULL,
+    0x8080070604030100ULL, 0x8080800706040301ULL, 0x8080800706040300ULL, 0x8080808007060403ULL,
+    0x8080070604020100ULL, 0x8080800706040201ULL, 0x8080800706040200ULL, 0x8080808007060402ULL,
+    0x8080800706040100ULL, 0x8080808007060401ULL, 0x8080808007060400ULL, 0x8080808080070604ULL,
+    0x8080070603020100ULL, 0x8080800706030201ULL, 0x8080800706030200ULL, 0x8080808007060302ULL,
+    0x8080800706030100ULL, 0x8080808007060301ULL, 0x8080808007060300ULL, 0x8080808080070603ULL,
+    0x8080800706020100ULL, 0x8080808007060201ULL, 0x8080808007060200ULL, 0x8080808080070602ULL,
+    0x8080808007060100ULL, 0x8080808080070601ULL, 0x8080808080070600ULL, 0x8080808080800706ULL,
+    0x8007050403020100ULL, 0x8080070504030201ULL, 0x8080070504030200ULL, 0x8080800705040302ULL,
+    0x8080070504030100ULL, 0x8080800705040301ULL, 0x8080800705040300ULL, 0x8080808007050403ULL,
+    0x8080070504020100ULL, 0x8080800705040201ULL, 0x8080800705040200ULL, 0x8080808007050402ULL,
+    0x8080800705040100ULL, 0x8080808007050401ULL, 0x8080808007050400ULL, 0x8080808080070504ULL,
+    0x8080070503020100ULL, 0x8080800705030201ULL, 0x8080800705030200ULL, 0x8080808007050302ULL,
+    0x8080800705030100ULL, 0x8080808007050301ULL, 0x8080808007050300ULL, 0x8080808080070503ULL,
+    0x8080800705020100ULL, 0x8080808007050201ULL, 0x8080808007050200ULL, 0x8080808080070502ULL,
+    0x8080808007050100ULL, 0x8080808080070501ULL, 0x8080808080070500ULL, 0x8080808080800705ULL,
+    0x8080070403020100ULL, 0x8080800704030201ULL, 0x8080800704030200ULL, 0x8080808007040302ULL,
+    0x8080800704030100ULL, 0x8080808007040301ULL, 0x8080808007040300ULL, 0x8080808080070403ULL,
+    0x8080800704020100ULL, 0x8080808007040201ULL, 0x8080808007040200ULL, 0x8080808080070402ULL,
+    0x8080808007040100ULL, 0x8080808080070401ULL, 0x8080808080070400ULL, 0x8080808080800704ULL,
+    0x8080800703020100ULL, 0x8080808007030201ULL, 0x8080808007030200ULL, 0x8080808080070302ULL,
+    0x8080808007030100ULL, 0x8080808080070301ULL, 0x8080808080070300ULL, 0x8080808080800703ULL,
+    0x8080808007020100ULL, 0x8080808080070201ULL, 0x8080808080070200ULL, 0x8080808080800702ULL,
+    0x8080808080070100ULL, 0x8080808080800701ULL, 0x8080808080800700ULL, 0x8080808080808007ULL,
+    0x8006050403020100ULL, 0x8080060504030201ULL, 0x8080060504030200ULL, 0x8080800605040302ULL,
+    0x8080060504030100ULL, 0x8080800605040301ULL, 0x8080800605040300ULL, 0x8080808006050403ULL,
+    0x8080060504020100ULL, 0x8080800605040201ULL, 0x8080800605040200ULL, 0x8080808006050402ULL,
+    0x8080800605040100ULL, 0x8080808006050401ULL, 0x8080808006050400ULL, 0x8080808080060504ULL,
+    0x8080060503020100ULL, 0x8080800605030201ULL, 0x8080800605030200ULL, 0x8080808006050302ULL,
+    0x8080800605030100ULL, 0x8080808006050301ULL, 0x8080808006050300ULL, 0x8080808080060503ULL,
+    0x8080800605020100ULL, 0x8080808006050201ULL, 0x8080808006050200ULL, 0x8080808080060502ULL,
+    0x8080808006050100ULL, 0x8080808080060501ULL, 0x8080808080060500ULL, 0x8080808080800605ULL,
+    0x8080060403020100ULL, 0x8080800604030201ULL, 0x8080800604030200ULL, 0x8080808006040302ULL,
+    0x8080800604030100ULL, 0x8080808006040301ULL, 0x8080808006040300ULL, 0x8080808080060403ULL,
+    0x8080800604020100ULL, 0x8080808006040201ULL, 0x8080808006040200ULL, 0x8080808080060402ULL,
+    0x8080808006040100ULL, 0x8080808080060401ULL, 0x8080808080060400ULL, 0x8080808080800604ULL,
+    0x8080800603020100ULL, 0x8080808006030201ULL, 0x8080808006030200ULL, 0x8080808080060302ULL,
+    0x8080808006030100ULL, 0x8080808080060301ULL, 0x8080808080060300ULL, 0x8080808080800603ULL,
+    0x8080808006020100ULL, 0x8080808080060201ULL, 0x8080808080060200ULL, 0x8080808080800602ULL,
+    0x8080808080060100ULL, 0x8080808080800601ULL, 0x8080808080800600ULL, 0x8080808080808006ULL,
+    0x8080050403020100ULL, 0x8080800504030201ULL, 0x8080800504030200ULL, 0x8080808005040302ULL,
+    0x8080800504030100ULL, 0x8080808005040301ULL, 0x8080808005040300ULL, 0x8080808080050403ULL,
+    0x8080800504020100ULL, 0x8080808005040201ULL, 0x8080808005040200ULL, 0x8080808080050402ULL,
+    0x8080808005040100ULL, 0x8080808080050401ULL, 0x8080808080050400ULL, 0x8080808080800504ULL,
+    0x8080800503020100ULL, 0x8080808005030201ULL, 0x8080808005030200ULL, 0x8080808080050302ULL,
+    0x8080808005030100ULL, 0x8080808080050301ULL, 0x8080808080050300ULL, 0x8080808080800503ULL,
+    0x8080808005020100ULL, 0x8080808080050201ULL, 0x8080808080050200ULL, 0x8080808080800502ULL,
+    0x8080808080050100ULL, 0x8080808080800501ULL, 0x8080808080800500ULL, 0x8080808080808005ULL,
+    0x8080800403020100ULL, 0x8080808004030201ULL, 0x8080808004030200ULL, 0x8080808080040302ULL,
+    0x8080808004030100ULL, 0x8080808080040301ULL, 0x8080808080040300ULL, 0x8080808080800403ULL,
+    0x8080808004020100ULL, 0x8080808080040201ULL, 0x8080808080040200ULL, 0x8080808080800402ULL,
+    0x8080808080040100ULL, 0x8080808080800401ULL, 0x8080808080800400ULL, 0x8080808080808004ULL,
+    0x8080808003020100ULL, 0x8080808080030201ULL, 0x8080808080030200ULL, 0x8080808080800302ULL,
+    0x8080808080030100ULL, 0x8080808080800301ULL, 0x8080808080800300ULL, 0x8080808080808003ULL,
+    0x8080808080020100ULL, 0x8080808080800201ULL, 0x8080808080800200ULL, 0x8080808080808002ULL,
+    0x8080808080800100ULL, 0x8080808080808001ULL, 0x8080808080808000ULL, 0x8080808080808080ULL
+};
+#endif
+
+
+/**
+ * @brief Function that copies the non whitespace bytes of an input to an output, which may be the input itself.
+ * With SIMD, whitespace is found a block at a time and blocks without any are copied whole. Otherwise each 8 byte
+ * group is compacted with a byte shuffle if SSSE3 or AVX2 is enabled, and with AVX-512 VBMI2 64 bytes at a time
+ * are compacted with a compress store. Every path writes the same bytes as the scalar loop.
+ * @ingroup intern
+ *
+ * @params[out]: output     -> buffer receiving the bytes. Never ahead of data if they overlap
+ * @params[in]: out_cap     -> number of bytes that may be written to output
+ * @params[in]: data        -> input to compact
+ * @params[in]: len         -> number of bytes in data
+ * @return: count           -> number of non whitespace bytes in data. Only the first out_cap of them are written
+ */
+_CSPLIT_FUNC
+size_t csplit_compact_space(char* output, size_t out_cap, const char* data, size_t len){
+    size_t count = 0;
+    size_t i = 0;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_REMOVE_WHITESPACE);
+    CSPLIT_STAT_ADD(bytes_scanned, len);
+#ifdef CSPLIT_AVX512_COMPRESS
+    for(; i + 64 <= len && count + 64 <= out_cap; i += 64){
+        __m512i bytes = _mm512_loadu_si512((const void*) (data + i));
+        __m512i control = _mm512_sub_epi8(bytes, _mm512_set1_epi8('\t'));
+        __mmask64 space = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8(' '))
+                        | _mm512_cmple_epu8_mask(control, _mm512_set1_epi8(4));
+        _mm512_mask_compressstoreu_epi8(output + count, ~space, bytes);
+        count = count + 64 - csplit_popcount(space);
+    }
+#endif
+#ifdef CSPLIT_SIMD_WIDTH
+    // every store stays below the end of the block just read, so compacting in place never clobbers unread input
+    for(; i + CSPLIT_SIMD_WIDTH <= len && count + CSPLIT_SIMD_WIDTH <= out_cap; i += CSPLIT_SIMD_WIDTH){
+        uint32_t mask = csplit_space_mask(data + i, CSPLIT_SIMD_WIDTH);
+        if(mask == 0){
+            memmove(output + count, data + i, CSPLIT_SIMD_WIDTH);
+            count = count + CSPLIT_SIMD_WIDTH;
+            continue;
+        }
+#if defined(CSPLIT_SSSE3) || defined(CSPLIT_AVX2)
+        size_t group;
+        for(group = 0; group < CSPLIT_SIMD_WIDTH; group += 8){
+            unsigned int group_mask = (mask >> group) & 0xFF;
+            __m128i bytes = _mm_loadl_epi64((const __m128i*) (data + i + group));
+            __m128i shuffle = _mm_loadl_epi64((const __m128i*) &csplit_compact_table[group_mask]);
+            _mm_storel_epi64((__m128i*) (output + count), _mm_shuffle_epi8(bytes, shuffle));
+            count = count + 8 - csplit_popcount(group_mask);
+        }
+#else
+        // without a shuffle, write every byte and only advance past the ones kept, avoiding a branch per byte
+        size_t j;
+        for(j = 0; j < CSPLIT_SIMD_WIDTH; j++){
+            output[count] = data[i + j];
+            count = count + (~(mask >> j) & 1);
+        }
+#endif
+    }
+#endif
+    for(; i < len; i++){
+        if(!csplit_is_space(data[i])){
+            if(count < out_cap)
+                output[count] = data[i];
+            count++;
+        }
+    }
+    CSPLIT_STAT_ADD(bytes_copied, count < out_cap ? count : out_cap);
+    return count;
+}
+
+
+/**
+ * @brief Function that checks if a byte is in a set of delimiters
+ * @ingroup intern
+ *
+ * @params[in]: set     -> set compiled with csplit_compile_charset
+ * @params[in]: c       -> byte to check
+ * @return: int         -> 1 if c is in the set, 0 otherwise
+ */
+_CSPLIT_FUNC
+int csplit_charset_contains(const CSplitCharset_t* set, char c){
+    unsigned char byte = (unsigned char) c;
+    return (set->bits[byte >> 3] >> (byte & 7)) & 1;
+}
+
+
+/**
+ * @brief Function that builds a set of single byte delimiters, so that splits on any of them can reuse it
+ * @ingroup set
+ *
+ * @params[out]: set    -> set to fill in
+ * @params[in]: chars   -> string holding every delimiter of the set
+ * @return: err         -> CSPLIT_TOO_SHORT if chars is empty
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_compile_charset(CSplitCharset_t* set, const char* chars){
+    if(set == NULL || chars == NULL || chars[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    memset(set, 0, sizeof(CSplitCharset_t));
+    for(; *chars != '\0'; chars++){
+        unsigned char byte = (unsigned char) *chars;
+        if(csplit_charset_contains(set, *chars))
+            continue;
+        set->bits[byte >> 3] = (uint8_t) (set->bits[byte >> 3] | (1u << (byte & 7)));
+        if(byte < 0x80)
+            set->lo_table[byte & 0x0F] = (uint8_t) (set->lo_table[byte & 0x0F] | (1u << (byte >> 4)));
+        else{
+            set->lo_table_high[byte & 0x0F] = (uint8_t) (set->lo_table_high[byte & 0x0F] | (1u << ((byte >> 4) - 8)));
+            set->has_high = 1;
+        }
+        if(set->num_members < sizeof(set->members))
+            set->members[set->num_members] = *chars;
+        set->num_members++;
+    }
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that computes the critical factorization, period and last byte shift table of the two-way
+ * search for a token. The token is read with a stride of step, so a step of -1 starting from its last byte
+ * gives the tables for searching backwards.
+ * @ingroup intern
+ *
+ * @params[in]: needle          -> first byte of the token in reading order
+ * @params[in]: len             -> length of the token in bytes, at least 2
+ * @params[in]: step            -> 1 to read the token forwards, -1 to read it backwards
+ * @params[out]: periodic       -> nonzero if the token is periodic
+ * @params[out]: critical_pos   -> position of the critical factorization
+ * @params[out]: period         -> shift used after a mismatch in the left half
+ * @params[out]: shift          -> table of 256 shifts, indexed by the last byte of a window
+ */
+_CSPLIT_FUNC
+void csplit_two_way_factorize(const unsigned char* needle, size_t len, ptrdiff_t step, int* periodic, size_t* critical_pos, size_t* period, size_t* shift){
+    size_t i, j, k, p, max_suffix, max_suffix_rev, suffix_period;
+    // maximal suffix for the natural byte ordering. SIZE_MAX stands in for -1, and wraps around on addition.
+    max_suffix = SIZE_MAX;
+    j = 0;
+    k = p = 1;
+    while(j + k < len){
+        unsigned char a = needle[(ptrdiff_t) (j + k) * step];
+        unsigned char b = needle[(ptrdiff_t) (max_suffix + k) * step];
+        if(a < b){
+            j = j + k;
+            k = 1;
+            p = j - max_suffix;
+        }
+        else if(a == b){
+            if(k != p)
+                k++;
+            else{
+                j = j + p;
+                k = 1;
+            }
+        }
+        else{
+            max_suffix = j++;
+            k = p = 1;
+        }
+    }
+    suffix_period = p;
+
+    // maximal suffix for the reversed byte ordering
+    max_suffix_rev = SIZE_MAX;
+    j = 0;
+    k = p = 1;
+    while(j + k < len){
+        unsigned char a = needle[(ptrdiff_t) (j + k) * step];
+        unsigned char b = needle[(ptrdiff_t) (max_suffix_rev + k) * step];
+        if(b < a){
+            j = j + k;
+            k = 1;
+            p = j - max_suffix_rev;
+        }
+        else if(a == b){
+            if(k != p)
+                k++;
+            else{
+                j = j + p;
+                k = 1;
+            }
+        }
+        else{
+            max_suffix_rev = j++;
+            k = p = 1;
+        }
+    }
+
+    // the critical factorization is the later of the two maximal suffixes
+    if(max_suffix_rev + 1 < max_suffix + 1)
+        *critical_pos = max_suffix + 1;
+    else{
+        *critical_pos = max_suffix_rev + 1;
+        suffix_period = p;
+    }
+
+    for(i = 0; i < *critical_pos; i++){
+        if(needle[(ptrdiff_t) i * step] != needle[(ptrdiff_t) (i + suffix_period) * step])
+            break;
+    }
+    *periodic = (i == *critical_pos);
+    if(*periodic)
+        *period = suffix_period;
+    else
+        *period = (*critical_pos > len - *critical_pos ? *critical_pos : len - *critical_pos) + 1;
+
+    // distance from each byte value's last occurrence before the final byte to the end of the token
+    for(i = 0; i < 256; i++)
+        shift[i] = len;
+    for(i = 0; i < len - 1; i++)
+        shift[needle[(ptrdiff_t) i * step]] = len - 1 - i;
+    shift[needle[(ptrdiff_t) (len - 1) * step]] = 0;
+}
+
+
+/**
+ * @brief Function that preprocesses a token so it can be reused for many splits. Tokens longer than
+ * CSPLIT_TWO_WAY_MIN_LEN get the critical factorizations and shift tables of the two-way search, both
+ * forwards and backwards, which keep searching linear in the worst case for splits in either direction.
+ * @ingroup set
+ *
+ * @params[out]: compiled   -> compiled token to fill in
+ * @params[in]: token       -> token text. Not copied, so it must outlive the compiled token
+ * @return: err             -> CSPLIT_TOO_SHORT if the token is empty
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_compile_token(CSplitToken_t* compiled, const char* token){
+    size_t len;
+    if(compiled == NULL || token == NULL || token[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    len = strlen(token);
+    compiled->text = token;
+    compiled->len = len;
+    compiled->two_way = len > CSPLIT_TWO_WAY_MIN_LEN;
+    compiled->periodic = 0;
+    compiled->critical_pos = 0;
+    compiled->period = 0;
+    compiled->rev_periodic = 0;
+    compiled->rev_critical_pos = 0;
+    compiled->rev_period = 0;
+    if(!compiled->two_way)
+        return CSPLIT_SUCCESS;
+
+    const unsigned char* needle = (const unsigned char*) token;
+    csplit_two_way_factorize(needle, len, 1, &compiled->periodic, &compiled->critical_pos, &compiled->period, compiled->shift);
+    // a reverse search is a forward search of the reversed token through the reversed input
+    csplit_two_way_factorize(needle + len - 1, len, -1, &compiled->rev_periodic, &compiled->rev_critical_pos,
+                             &compiled->rev_period, compiled->rev_shift);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that finds the first occurrence of a compiled token in a buffer of known length
+ * @ingroup intern
+ *
+ * @params[in]: compiled    -> token compiled with csplit_compile_token
+ * @params[in]: haystack    -> buffer to search
+ * @params[in]: hay_len     -> length of the buffer in bytes
+ * @return: location        -> pointer to the first match, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_find_compiled(const CSplitToken_t* compiled, const char* haystack, size_t hay_len){
+    const unsigned char* needle = (const unsigned char*) compiled->text;
+    const unsigned char* hay = (const unsigned char*) haystack;
+    size_t len = compiled->len;
+    size_t suffix = compiled->critical_pos;
+    size_t period = compiled->period;
+    size_t i, j = 0, memory = 0, shift;
+    if(!compiled->two_way)
+        return csplit_find_token(haystack, hay_len, compiled->text, len);
+    if(len > hay_len)
+        return NULL;
+
+    while(j <= hay_len - len){
+        // check the last byte of the window first, and skip ahead if it can't be part of a match
+        shift = compiled->shift[hay[j + len - 1]];
+        if(shift > 0){
+            // a periodic token with a mismatch in its last period can't match before the mismatch
+            if(compiled->periodic && memory != 0 && shift < period)
+                shift = len - period;
+            memory = 0;
+            j = j + shift;
+            continue;
+        }
+        // compare the right half, skipping bytes remembered from the previous window
+        i = (compiled->periodic && memory > suffix) ? memory : suffix;
+        while(i < len - 1 && needle[i] == hay[i + j])
+            i++;
+        if(i >= len - 1){
+            // then the left half, right to left
+            size_t stop = compiled->periodic ? memory : 0;
+            i = suffix;
+            while(i > stop && needle[i - 1] == hay[i - 1 + j])
+                i--;
+            if(i <= stop)
+                return haystack + j;
+            j = j + period;
+            if(compiled->periodic)
+                memory = len - period;
+        }
+        else{
+            j = j + i - suffix + 1;
+            memory = 0;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Function that finds the last occurrence of a compiled token in a buffer of known length. Runs the
+ * two-way search of csplit_find_compiled over the buffer read backwards, with the reverse tables.
+ * @ingroup intern
+ *
+ * @params[in]: compiled    -> token compiled with csplit_compile_token
+ * @params[in]: haystack    -> buffer to search
+ * @params[in]: hay_len     -> length of the buffer in bytes
+ * @return: location        -> pointer to the last match, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_rfind_compiled(const CSplitToken_t* compiled, const char* haystack, size_t hay_len){
+    size_t len = compiled->len;
+    size_t suffix = compiled->rev_critical_pos;
+    size_t period = compiled->rev_period;
+    size_t i, j = 0, memory = 0, shift;
+    if(!compiled->two_way)
+        return csplit_rfind_token(haystack, hay_len, compiled->text, len);
+    if(len > hay_len)
+        return NULL;
+    // byte x of the reversed token or input is at offset -x from these
+    const unsigned char* needle = (const unsigned char*) compiled->text + len - 1;
+    const unsigned char* hay = (const unsigned char*) haystack + hay_len - 1;
+
+    while(j <= hay_len - len){
+        shift = compiled->rev_shift[*(hay - (j + len - 1))];
+        if(shift > 0){
+            if(compiled->rev_periodic && memory != 0 && shift < period)
+                shift = len - period;
+            memory = 0;
+            j = j + shift;
+            continue;
+        }
+        i = (compiled->rev_periodic && memory > suffix) ? memory : suffix;
+        while(i < len - 1 && *(needle - i) == *(hay - (i + j)))
+            i++;
+        if(i >= len - 1){
+            size_t stop = compiled->rev_periodic ? memory : 0;
+            i = suffix;
+            while(i > stop && *(needle - (i - 1)) == *(hay - (i - 1 + j)))
+                i--;
+            if(i <= stop)
+                return haystack + hay_len - j - len;
+            j = j + period;
+            if(compiled->rev_periodic)
+                memory = len - period;
+        }
+        else{
+            j = j + i - suffix + 1;
+            memory = 0;
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Function that finds the next occurrence of a single byte token for a forward split iterator.
+ * With SIMD, each block of the input is compared once, and token positions are then taken from the
+ * resulting bitmask. Otherwise it uses memchr.
+ * @ingroup intern
+ *
+ * @params[in]: iter        -> forward iterator with a token of length 1
+ * @return: location        -> pointer to the next token at or after iter->pos, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_iter_find_byte(CSplitIter_t* iter){
+#ifdef CSPLIT_SIMD_WIDTH
+    size_t in_len = iter->end - iter->begin;
+    while(1){
+        if(iter->mask != 0){
+            // pop the lowest token position from the current block
+            const char* found = iter->begin + iter->mask_off + csplit_ctz(iter->mask);
+            iter->mask = iter->mask & (iter->mask - 1);
+            return found;
+        }
+        if(iter->block_off >= in_len)
+            return NULL;
+        size_t block_len = in_len - iter->block_off;
+        if(block_len > CSPLIT_SIMD_WIDTH)
+            block_len = CSPLIT_SIMD_WIDTH;
+        if(iter->charset != NULL)
+            iter->mask = csplit_charset_mask(iter->charset, iter->begin + iter->block_off, block_len);
+        else
+            iter->mask = csplit_byte_mask(iter->begin + iter->block_off, block_len, iter->token[0]);
+        iter->mask_off = iter->block_off;
+        iter->block_off = iter->block_off + block_len;
+    }
+#else
+    if(iter->charset != NULL){
+        const char* current;
+        for(current = iter->pos; current < iter->end; current++){
+            if(csplit_charset_contains(iter->charset, *current))
+                return current;
+        }
+        return NULL;
+    }
+    return (const char*) memchr(iter->pos, iter->token[0], iter->end - iter->pos);
+#endif
+}
+
+
+/**
+ * @brief Function that finds the previous occurrence of a single byte token for a reverse split iterator,
+ * scanning from the end of the input towards the start. With SIMD, blocks are compared once and token
+ * positions are taken from the resulting bitmask, highest first.
+ * @ingroup intern
+ *
+ * @params[in]: iter        -> reverse iterator with a token of length 1
+ * @return: location        -> pointer to the last token before iter->pos, or NULL if there is none
+ */
+_CSPLIT_FUNC
+const char* csplit_iter_rfind_byte(CSplitIter_t* iter){
+#ifdef CSPLIT_SIMD_WIDTH
+    while(1){
+        if(iter->mask != 0){
+            // pop the highest token position from the current block
+            unsigned int index = csplit_last_bit(iter->mask);
+            iter->mask = iter->mask & ~((uint32_t) 1 << index);
+            return iter->begin + iter->mask_off + index;
+        }
+        if(iter->block_off == 0)
+            return NULL;
+        size_t block_len = iter->block_off;
+        if(block_len > CSPLIT_SIMD_WIDTH)
+            block_len = CSPLIT_SIMD_WIDTH;
+        iter->block_off = iter->block_off - block_len;
+        if(iter->charset != NULL)
+            iter->mask = csplit_charset_mask(iter->charset, iter->begin + iter->block_off, block_len);
+        else
+            iter->mask = csplit_byte_mask(iter->begin + iter->block_off, block_len, iter->token[0]);
+        iter->mask_off = iter->block_off;
+    }
+#else
+    const char* current = iter->pos;
+    while(current > iter->begin){
+        current--;
+        if(iter->charset != NULL ? csplit_charset_contains(iter->charset, *current) : *current == iter->token[0])
+            return current;
+    }
+    return NULL;
+#endif
+}
+
+
+/**
+ * @brief Function that prepares a split iterator. A negative max_splits will split from the end of the input.
+ * @ingroup intern
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input       -> input buffer which will be split. Must outlive the iterator
+ * @params[in]: in_len      -> length of the input buffer in bytes
+ * @params[in]: token       -> token on which to split. Must outlive the iterator
+ * @params[in]: token_len   -> length of the token in bytes
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ */
+_CSPLIT_FUNC
+void csplit_iter_setup(CSplitIter_t* iter, const char* input, size_t in_len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    iter->begin = input;
+    iter->end = input + in_len;
+    iter->token = token;
+    iter->token_len = token_len;
+    iter->compiled = NULL;
+    iter->charset = NULL;
+    iter->whitespace = 0;
+    iter->reverse = max_splits < 0;
+    if(iter->reverse){
+        iter->splits_left = (size_t) -(max_splits + 1) + 1;
+        iter->pos = iter->end;
+    }
+    else{
+        iter->splits_left = (size_t) max_splits;
+        iter->pos = iter->begin;
+    }
+    iter->done = 0;
+    iter->block_off = iter->reverse ? in_len : 0;
+    iter->mask_off = 0;
+    iter->mask = 0;
+}
+
+
+/**
+ * @brief Function that prepares a split iterator that searches for a compiled token.
+ * @ingroup intern
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input       -> input buffer which will be split. Must outlive the iterator
+ * @params[in]: in_len      -> length of the input buffer in bytes
+ * @params[in]: compiled    -> token compiled with csplit_compile_token. Must outlive the iterator
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ */
+_CSPLIT_FUNC
+void csplit_iter_setup_compiled(CSplitIter_t* iter, const char* input, size_t in_len, const CSplitToken_t* compiled, ptrdiff_t max_splits){
+    csplit_iter_setup(iter, input, in_len, compiled->text, compiled->len, max_splits);
+    iter->compiled = compiled;
+}
+
+
+/**
+ * @brief Function that prepares a split iterator that splits on any byte of a set. Every delimiter is one byte
+ * long, so the set is searched for like a single byte token.
+ * @ingroup intern
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input       -> input buffer which will be split. Must outlive the iterator
+ * @params[in]: in_len      -> length of the input buffer in bytes
+ * @params[in]: set         -> set compiled with csplit_compile_charset. Must outlive the iterator
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ */
+_CSPLIT_FUNC
+void csplit_iter_setup_charset(CSplitIter_t* iter, const char* input, size_t in_len, const CSplitCharset_t* set, ptrdiff_t max_splits){
+    csplit_iter_setup(iter, input, in_len, NULL, 1, max_splits);
+    iter->charset = set;
+}
+
+
+/**
+ * @brief Function that prepares a split iterator that splits on runs of whitespace, like str.split() in python
+ * @ingroup intern
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input       -> input buffer which will be split. Must outlive the iterator
+ * @params[in]: in_len      -> length of the input buffer in bytes
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ */
+_CSPLIT_FUNC
+void csplit_iter_setup_whitespace(CSplitIter_t* iter, const char* input, size_t in_len, ptrdiff_t max_splits){
+    csplit_iter_setup(iter, input, in_len, NULL, 1, max_splits);
+    iter->whitespace = 1;
+}
+
+
+/**
+ * @brief Function that returns the next fragment of a split on runs of whitespace. Whitespace at the ends of the
+ * input is skipped, so no fragment is ever empty. Once max_splits is reached, the rest of the input, without its
+ * whitespace on the side the split started from, is the last fragment.
+ * @ingroup intern
+ *
+ * @params[in]: iter        -> iterator prepared with csplit_iter_setup_whitespace
+ * @params[out]: fragment   -> view of the next fragment
+ * @return: int             -> 1 if a fragment was returned, 0 if the split is complete
+ */
+_CSPLIT_FUNC
+int csplit_iter_next_whitespace(CSplitIter_t* iter, CSplitView_t* fragment){
+    if(iter->done) return 0;
+    if(!iter->reverse){
+        const char* start = csplit_find_space(iter->pos, iter->end, 0);
+        const char* stop = iter->end;
+        if(start == iter->end){
+            iter->done = 1;
+            return 0;
+        }
+        if(iter->splits_left > 0){
+            stop = csplit_find_space(start, iter->end, 1);
+            iter->splits_left--;
+        }
+        fragment->text = start;
+        fragment->len = stop - start;
+        CSPLIT_STAT_ADD(bytes_scanned, stop - iter->pos);
+        iter->pos = stop;
+        iter->done = stop == iter->end;
+    }
+    else{
+        const char* last = csplit_rfind_space(iter->begin, iter->pos, 0);
+        const char* start = NULL;
+        if(last == NULL){
+            iter->done = 1;
+            return 0;
+        }
+        if(iter->splits_left > 0){
+            start = csplit_rfind_space(iter->begin, last, 1);
+            iter->splits_left--;
+        }
+        fragment->text = start == NULL ? iter->begin : start + 1;
+        fragment->len = last + 1 - fragment->text;
+        CSPLIT_STAT_ADD(bytes_scanned, iter->pos - fragment->text);
+        iter->pos = fragment->text;
+        iter->done = start == NULL;
+    }
+    CSPLIT_STAT_ADD(fragments, 1);
+    return 1;
+}
+
+
+/**
+ * @brief Version of csplit_iter_init for input and token of known length, which may contain NUL characters.
+ * @ingroup core
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: data        -> input which will be split. Must outlive the iterator
+ * @params[in]: len         -> number of bytes in data
+ * @params[in]: token       -> bytes on which to split. Must outlive the iterator
+ * @params[in]: token_len   -> number of bytes in token
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of input.
+ * @return: err             -> CSPLIT_TOO_SHORT if the input or token is empty, in which case the iterator returns nothing
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_n(CSplitIter_t* iter, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    if(iter == NULL)
+        return CSPLIT_TOO_SHORT;
+    if(data == NULL || token == NULL || len == 0 || token_len == 0){
+        memset(iter, 0, sizeof(CSplitIter_t));
+        iter->done = 1;
+        return CSPLIT_TOO_SHORT;
+    }
+    CSPLIT_STAT_CALL(CSPLIT_CALL_ITER);
+    csplit_iter_setup(iter, data, len, token, token_len, max_splits);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that prepares an iterator to read the fragments of a split one at a time with csplit_iter_next,
+ * without allocating or copying anything. The split can be stopped at any point by no longer calling csplit_iter_next.
+ * @ingroup core
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input_str   -> input string which will be split. Must outlive the iterator
+ * @params[in]: token       -> string on which to split. Must outlive the iterator
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ * @return: err             -> CSPLIT_TOO_SHORT if the input or token is empty, in which case the iterator returns nothing
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init(CSplitIter_t* iter, const char* input_str, const char* token, int max_splits){
+    if(input_str == NULL || token == NULL)
+        return csplit_iter_init_n(iter, NULL, 0, NULL, 0, max_splits);
+    return csplit_iter_init_n(iter, input_str, strlen(input_str), token, strlen(token), max_splits);
+}
+
+
+/**
+ * @brief Function that returns the next fragment of a split. In reverse mode fragments are returned
+ * starting from the end of the input.
+ * @ingroup core
+ *
+ * @params[in]: iter        -> iterator prepared with csplit_iter_init
+ * @params[out]: fragment   -> view of the next fragment
+ * @return: int             -> 1 if a fragment was returned, 0 if the split is complete
+ */
+_CSPLIT_FUNC
+int csplit_iter_next(CSplitIter_t* iter, CSplitView_t* fragment){
+    const char* found = NULL;
+    if(iter->whitespace) return csplit_iter_next_whitespace(iter, fragment);
+    if(iter->done) return 0;
+    if(!iter->reverse){
+        if(iter->splits_left > 0){
+            if(iter->token_len == 1)
+                found = csplit_iter_find_byte(iter);
+            else if(iter->compiled != NULL)
+                found = csplit_find_compiled(iter->compiled, iter->pos, iter->end - iter->pos);
+            else
+                found = csplit_find_token(iter->pos, iter->end - iter->pos, iter->token, iter->token_len);
+        }
+        fragment->text = iter->pos;
+        if(found == NULL){
+            // no more splits, remainder of the input is the last fragment
+            fragment->len = iter->end - iter->pos;
+            iter->done = 1;
+        }
+        else{
+            fragment->len = found - iter->pos;
+            iter->pos = found + iter->token_len;
+            iter->splits_left--;
+        }
+    }
+    else{
+        if(iter->splits_left > 0){
+            if(iter->token_len == 1)
+                found = csplit_iter_rfind_byte(iter);
+            else if(iter->compiled != NULL)
+                found = csplit_rfind_compiled(iter->compiled, iter->begin, iter->pos - iter->begin);
+            else
+                found = csplit_rfind_token(iter->begin, iter->pos - iter->begin, iter->token, iter->token_len);
+        }
+        if(found == NULL){
+            fragment->text = iter->begin;
+            iter->done = 1;
+        }
+        else{
+            fragment->text = found + iter->token_len;
+            iter->splits_left--;
+        }
+        fragment->len = iter->pos - fragment->text;
+        if(found != NULL)
+            iter->pos = found;
+    }
+    CSPLIT_STAT_ADD(fragments, 1);
+    CSPLIT_STAT_ADD(bytes_scanned, fragment->len + (found != NULL ? iter->token_len : 0));
+    return 1;
+}
+
+
+/**
+ * @brief Function that allocates a fragment owned by the list, holding a NUL terminated copy of a view.
+ * The fragment is not linked into the list.
+ * @ingroup intern
+ *
+ * @params[in]: list    -> list that will own the fragment
+ * @params[in]: view    -> view of the text to copy
+ * @return: fragment    -> the new fragment, or NULL if allocation failed or the list is full
+ */
+_CSPLIT_FUNC
+CSplitFragment_t* csplit_new_fragment(CSplitList_t* list, const CSplitView_t* view){
+    CSplitFragment_t* fragment;
+    // num_elems is an int, so a list can never hold more than INT_MAX fragments
+    if(list->num_elems == INT_MAX)
+        return NULL;
+    if(list->arena != NULL){
+        // fragment and its text share a single allocation from the arena
+        fragment = (CSplitFragment_t*) csplit_arena_alloc(list, sizeof(CSplitFragment_t) + view->len + 1);
+        if(fragment == NULL)
+            return NULL;
+        fragment->text = (char*) (fragment + 1);
+        fragment->next = NULL;
+        fragment->prev = NULL;
+    }
+    else if(list->spare != NULL){
+        // reuse a fragment kept by csplit_reset_list, growing its text if it is too small
+        fragment = list->spare;
+        if(fragment->text_cap < view->len + 1){
+            // the old text is about to be overwritten, so it is replaced rather than reallocated and copied
+            size_t new_cap = (view->len + 16) & ~(size_t) 15;
+            char* new_text = (char*) csplit_list_alloc(list, new_cap);
+            if(new_text == NULL)
+                return NULL;
+            csplit_list_free(list, fragment->text, fragment->text_cap);
+            fragment->text = new_text;
+            fragment->text_cap = new_cap;
+        }
+        list->spare = fragment->next;
+        fragment->next = NULL;
+        fragment->prev = NULL;
+    }
+    else{
+        // every field is set here, so the fragment is not zero filled
+        fragment = (CSplitFragment_t*) csplit_list_alloc(list, sizeof(CSplitFragment_t));
+        if(fragment == NULL)
+            return NULL;
+        fragment->text = (char*) csplit_list_alloc(list, view->len + 1);
+        if(fragment->text == NULL){
+            csplit_list_free(list, fragment, sizeof(CSplitFragment_t));
+            return NULL;
+        }
+        fragment->text_cap = view->len + 1;
+        fragment->next = NULL;
+        fragment->prev = NULL;
+    }
+    memcpy(fragment->text, view->text, view->len);
+    fragment->text[view->len] = '\0';
+    CSPLIT_STAT_ADD(bytes_copied, view->len);
+    return fragment;
+}
+
+
+/**
+ * @brief Function that links a fragment into the list in front of another fragment
+ * @ingroup intern
+ *
+ * @params[out]: list       -> The list with fragment inserted
+ * @params[in]: fragment    -> fragment to insert
+ * @params[in]: before      -> fragment already in the list to insert in front of, or NULL to append to the tail
+ */
+_CSPLIT_FUNC
+void csplit_insert_fragment(CSplitList_t* list, CSplitFragment_t* fragment, CSplitFragment_t* before){
+    if(before == NULL){
+        csplit_append_fragment(list, fragment);
+        return;
+    }
+    list->num_elems = list->num_elems + 1;
+    fragment->next = before;
+    fragment->prev = before->prev;
+    if(before->prev == NULL)
+        list->head = fragment;
+    else
+        before->prev->next = fragment;
+    before->prev = fragment;
+}
+
+
+/**
+ * @brief Function that copies a fragment view into a new NUL terminated fragment at the end of the list
+ * @ingroup intern
+ *
+ * @params[out]: list   -> The list with the copied fragment appended to the tail
+ * @params[in]: view    -> view of the text to copy
+ * @return: err         -> error code if there was a problem pushing to the list
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_push_view_to_list(CSplitList_t* list, const CSplitView_t* view){
+    CSplitFragment_t* fragment;
+    if(list == NULL)
+        return CSPLIT_TOO_SHORT;
+    fragment = csplit_new_fragment(list, view);
+    if(fragment == NULL)
+        return CSPLIT_BUFF_EXCEEDED;
+    csplit_append_fragment(list, fragment);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that copies every fragment produced by a split iterator onto the end of a list.
+ * Fragments of a reverse split are linked in input order as they are found, so the list never needs reversing.
+ * @ingroup intern
+ *
+ * @params[out]: list   -> The list with the copied fragments appended
+ * @params[in]: iter    -> prepared split iterator
+ * @return: err         -> error code if there was a problem pushing to the list
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_list_from_iter(CSplitList_t* list, CSplitIter_t* iter){
+    CSplitFragment_t* first = NULL;
+    CSplitView_t view;
+    if(list == NULL)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_LIST);
+    while(csplit_iter_next(iter, &view)){
+        CSplitFragment_t* fragment = csplit_new_fragment(list, &view);
+        if(fragment == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+        // a reverse split finds fragments back to front, so each goes in front of the previous one
+        if(iter->reverse){
+            csplit_insert_fragment(list, fragment, first);
+            first = fragment;
+        }
+        else
+            csplit_append_fragment(list, fragment);
+    }
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that runs csplit on a particular string from the end of the input. Called if max_splits < 0
+ * @ingroup intern
+ * 
+ * @params[out]: list       -> split input string into this list structure
+ * @params[in]: input_str   -> input string
+ * @params[in]: token       -> character on which to split
+ * @params[in]: max_splits  -> maximum number of splits. If negative will split from end of string
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_rstr(CSplitList_t* list, char* input_str, char* token, int max_splits){
+    CSplitIter_t iter;
+
+    // scan right to left, stopping once |max_splits| tokens were found. Fragments are linked
+    // into the list in input order as they are found.
+    csplit_iter_setup(&iter, input_str, strlen(input_str), token, strlen(token), max_splits);
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+/**
+ * @brief Function that splits a given input string based on another string.
+ * @ingroup intern
+ * 
+ * @params[out]: list           -> output list splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_str(CSplitList_t* list, char* input_str, char* token, int max_splits){
+    if(max_splits < 0)
+        return csplit_rstr(list, input_str, token, max_splits);
+    CSplitIter_t iter;
+
+    // copy each fragment found by the shared scanner into the list
+    csplit_iter_setup(&iter, input_str, strlen(input_str), token, strlen(token), max_splits);
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+
+/**
+ * @brief Function that allows user to split based on a limited number of splits, either forward
+ * or in reverse. A max_splits >= len(input_str) will guarantee all possible splits
+ * @ingroup core
+ * 
+ * @params[out]: list           -> output list splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_lim(CSplitList_t* list, char* input_str, char* token, int max_splits){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_lim_n(list, input_str, strlen(input_str), token, strlen(token), max_splits);
+}
+
+
+/**
+ * @brief Version of csplit_lim for input and token of known length. Never calls strlen, so the input
+ * may contain NUL characters, need not be NUL terminated, and may be larger than INT_MAX bytes.
+ * Fragments are still copied into the list with a NUL terminator after their last byte.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting data on token
+ * @params[in]: data            -> input which will be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of input.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_lim_n(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    CSplitIter_t iter;
+    if(list == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup(&iter, data, len, token, token_len, max_splits);
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+/**
+ * @brief Version of csplit for input and token of known length. Splits on every occurrence of the token.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting data on token
+ * @params[in]: data            -> input which will be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_n(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len){
+    return csplit_lim_n(list, data, len, token, token_len, PTRDIFF_MAX);
+}
+
+
+/**
+ * @brief Top level csplit function call. Outputs a csplit list split on a string token. Calls
+ * csplit_lim with max_splits = len(input_str), ensuring that all possible splits will be made.
+ * @ingroup core
+ * 
+ * @params[out]: list           -> output list splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split 
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit(CSplitList_t* list, char* input_str, char* token){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_n(list, input_str, strlen(input_str), token, strlen(token));
+}
+
+
+/**
+ * @brief Function that runs csplit and then reverses the output.
+ * @ingroup core
+ * 
+ * @params[out]: output_list    -> output list splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split 
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t rcsplit(CSplitList_t* output_list, char* input_str, char* token){
+    CSplitError_t err = csplit(output_list, input_str, token);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    err = csplit_reverse_list(output_list);
+    return err;
+}
+
+
+/**
+ * @brief Function that reverses an array of fragment views in place
+ * @ingroup intern
+ *
+ * @params[out]: views      -> array of views to reverse
+ * @params[in]: num_views   -> number of views in the array
+ */
+_CSPLIT_FUNC
+void csplit_reverse_views(CSplitView_t* views, size_t num_views){
+    size_t i;
+    for(i = 0; i < num_views / 2; i++){
+        CSplitView_t temp = views[i];
+        views[i] = views[num_views - 1 - i];
+        views[num_views - 1 - i] = temp;
+    }
+}
+
+
+/**
+ * @brief Function that stores every fragment produced by a split iterator in an array of views
+ * @ingroup intern
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: iter            -> prepared split iterator
+ * @return:     err             -> CSPLIT_BUFF_EXCEEDED if views was too small, in which case its contents are unspecified
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_views_from_iter(CSplitView_t* views, size_t max_views, size_t* num_views, CSplitIter_t* iter){
+    CSplitView_t view;
+    size_t count = 0;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_VIEW);
+    while(csplit_iter_next(iter, &view)){
+        if(count < max_views)
+            views[count] = view;
+        count++;
+    }
+    *num_views = count;
+    if(count > max_views)
+        return CSPLIT_BUFF_EXCEEDED;
+    // reverse splits are found back to front, so flip them into input order
+    if(iter->reverse)
+        csplit_reverse_views(views, count);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that splits a given input string into an array of zero-copy views.
+ * @ingroup intern
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> CSPLIT_BUFF_EXCEEDED if views was too small, in which case its contents are unspecified
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_str(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token, int max_splits){
+    CSplitIter_t iter;
+    csplit_iter_setup(&iter, input_str, strlen(input_str), token, strlen(token), max_splits);
+    return csplit_views_from_iter(views, max_views, num_views, &iter);
+}
+
+
+/**
+ * @brief Zero-copy version of csplit_lim. Fills an array of views pointing into the input string
+ * instead of allocating a list, so no memory is allocated and no bytes are copied.
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_lim(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token, int max_splits){
+    *num_views = 0;
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_view_lim_n(views, max_views, num_views, input_str, strlen(input_str), token, strlen(token), max_splits);
+}
+
+
+/**
+ * @brief Version of csplit_view_lim for input and token of known length, which may contain NUL characters.
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: data            -> input which will be split. Views point into it.
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of input.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_lim_n(CSplitView_t* views, size_t max_views, size_t* num_views, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    CSplitIter_t iter;
+    *num_views = 0;
+    if(data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup(&iter, data, len, token, token_len, max_splits);
+    return csplit_views_from_iter(views, max_views, num_views, &iter);
+}
+
+
+/**
+ * @brief Zero-copy version of csplit. Splits on every occurrence of the token.
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token){
+    *num_views = 0;
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_view_lim_n(views, max_views, num_views, input_str, strlen(input_str), token, strlen(token), PTRDIFF_MAX);
+}
+
+
+/**
+ * @brief Zero-copy version of rcsplit. Splits on every occurrence of the token, with the views in reverse order.
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, last fragment first
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t rcsplit_view(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const char* token){
+    CSplitError_t err = csplit_view(views, max_views, num_views, input_str, token);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    csplit_reverse_views(views, *num_views);
+    return err;
+}
+
+
+
+/**
+ * @brief Function for initializing a csplit array
+ * @ingroup set
+ *
+ * @return: array           -> an allocated, empty csplit array
+ */
+_CSPLIT_FUNC
+CSplitArray_t* csplit_init_array(){
+    CSplitArray_t* array = (CSplitArray_t*) csplit_calloc(1, sizeof(CSplitArray_t));
+    return array;
+}
+
+
+/**
+ * @brief Clears all memory for an allocated csplit array. The split input strings are not freed.
+ * @ingroup set
+ *
+ * @params[in]: array   -> a previously allocated csplit array to be freed
+ */
+_CSPLIT_FUNC
+void csplit_clear_array(CSplitArray_t* array){
+    if(array == NULL) return;
+    csplit_free(array->elems);
+    csplit_free(array);
+}
+
+
+/**
+ * @brief Function that appends a view to the end of the array, doubling its capacity when full
+ * @ingroup intern
+ *
+ * @params[out]: array  -> The array with the view appended
+ * @params[in]: view    -> view to append
+ * @return: err         -> error code if there was a problem growing the array
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_push_to_array(CSplitArray_t* array, const CSplitView_t* view){
+    if(array == NULL || view == NULL)
+        return CSPLIT_TOO_SHORT;
+    // appending to the logical end of a reversed array requires storing it in order first
+    if(array->reversed){
+        csplit_reverse_views(array->elems, array->num_elems);
+        array->reversed = 0;
+    }
+    if(array->num_elems == array->capacity){
+        size_t new_capacity = array->capacity == 0 ? 16 : array->capacity * 2;
+        CSplitView_t* new_elems = (CSplitView_t*) csplit_realloc(array->elems, new_capacity * sizeof(CSplitView_t));
+        if(new_elems == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+        array->elems = new_elems;
+        array->capacity = new_capacity;
+    }
+    array->elems[array->num_elems] = *view;
+    array->num_elems++;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that appends every fragment produced by a split iterator to an array
+ * @ingroup intern
+ *
+ * @params[out]: array  -> The array with the views appended
+ * @params[in]: iter    -> prepared split iterator
+ * @return: err         -> error code if there was a problem growing the array
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_from_iter(CSplitArray_t* array, CSplitIter_t* iter){
+    CSplitError_t err = CSPLIT_SUCCESS;
+    CSplitView_t view;
+    size_t first = array->num_elems;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_ARRAY);
+    while(err == CSPLIT_SUCCESS && csplit_iter_next(iter, &view))
+        err = csplit_push_to_array(array, &view);
+    // reverse splits are found back to front, so flip the new views into input order
+    if(iter->reverse)
+        csplit_reverse_views(array->elems + first, array->num_elems - first);
+    return err;
+}
+
+
+/**
+ * @brief Function that returns the view at a certain index in the array, in constant time
+ * @ingroup core
+ *
+ * @params[in]: array   -> array generated by csplit_array
+ * @params[in]: index   -> index to search for (can be negative for getting at index from back of array)
+ * @return: view        -> view at the given index or NULL if index out of range.
+ */
+_CSPLIT_FUNC
+const CSplitView_t* csplit_get_view_at_index(CSplitArray_t* array, ptrdiff_t index){
+    size_t target_index;
+    if(index < 0){
+        if((size_t) -(index + 1) >= array->num_elems)
+            return NULL;
+        target_index = array->num_elems - 1 - (size_t) -(index + 1);
+    }
+    else{
+        if((size_t) index >= array->num_elems)
+            return NULL;
+        target_index = (size_t) index;
+    }
+    if(array->reversed)
+        target_index = array->num_elems - 1 - target_index;
+    return &array->elems[target_index];
+}
+
+
+/**
+ * @brief Function that reverses the array in constant time, by changing the direction it is read in
+ * @ingroup set
+ *
+ * @params[out]: array  -> array to reverse
+ * @return: err         -> error code if there is an error
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_reverse_array(CSplitArray_t* array){
+    if(array == NULL)
+        return CSPLIT_TOO_SHORT;
+    array->reversed = !array->reversed;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Version of csplit_lim that appends views to a csplit array instead of copies to a list.
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_lim(CSplitArray_t* array, const char* input_str, const char* token, int max_splits){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_array_lim_n(array, input_str, strlen(input_str), token, strlen(token), max_splits);
+}
+
+
+/**
+ * @brief Version of csplit_array_lim for input and token of known length, which may contain NUL characters.
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting data on token
+ * @params[in]: data            -> input which will be split. Views point into it.
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of input.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_lim_n(CSplitArray_t* array, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    CSplitIter_t iter;
+    if(array == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup(&iter, data, len, token, token_len, max_splits);
+    return csplit_array_from_iter(array, &iter);
+}
+
+
+/**
+ * @brief Version of csplit that appends views to a csplit array. Splits on every occurrence of the token.
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array(CSplitArray_t* array, const char* input_str, const char* token){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_array_lim_n(array, input_str, strlen(input_str), token, strlen(token), PTRDIFF_MAX);
+}
+
+
+/**
+ * @brief Function that runs csplit_array and then reverses the output, in constant time.
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on string token
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> string on which to split
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t rcsplit_array(CSplitArray_t* array, const char* input_str, const char* token){
+    CSplitError_t err = csplit_array(array, input_str, token);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_reverse_array(array);
+}
+
+
+
+/**
+ * @brief Version of csplit_lim that splits on a token compiled with csplit_compile_token, so repeated
+ * splits on the same token do no per call setup.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting input str on the token
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> compiled token on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_compiled(CSplitList_t* list, const char* input_str, const CSplitToken_t* token, int max_splits){
+    CSplitIter_t iter;
+    if(input_str == NULL || token == NULL || input_str[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup_compiled(&iter, input_str, strlen(input_str), token, max_splits);
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+/**
+ * @brief Zero-copy version of csplit_compiled, filling an array of views like csplit_view_lim
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> compiled token on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_compiled(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const CSplitToken_t* token, int max_splits){
+    CSplitIter_t iter;
+    *num_views = 0;
+    if(input_str == NULL || token == NULL || input_str[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup_compiled(&iter, input_str, strlen(input_str), token, max_splits);
+    return csplit_views_from_iter(views, max_views, num_views, &iter);
+}
+
+
+/**
+ * @brief Version of csplit_compiled that appends views to a csplit array
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on the token
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: token           -> compiled token on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_compiled(CSplitArray_t* array, const char* input_str, const CSplitToken_t* token, int max_splits){
+    CSplitIter_t iter;
+    if(array == NULL || input_str == NULL || token == NULL || input_str[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup_compiled(&iter, input_str, strlen(input_str), token, max_splits);
+    return csplit_array_from_iter(array, &iter);
+}
+
+
+
+/**
+ * @brief Function for initializing a streaming splitter, which splits input that arrives in chunks
+ * @ingroup set
+ *
+ * @params[in]: token       -> bytes on which to split. Copied, so it need not outlive the stream
+ * @params[in]: token_len   -> number of bytes in token
+ * @return: stream          -> an allocated streaming splitter, or NULL if the token is empty or allocation failed
+ */
+_CSPLIT_FUNC
+CSplitStream_t* csplit_init_stream(const char* token, size_t token_len){
+    if(token == NULL || token_len == 0)
+        return NULL;
+    // the token copy is stored right after the stream itself
+    CSplitStream_t* stream = (CSplitStream_t*) csplit_calloc(1, sizeof(CSplitStream_t) + token_len);
+    if(stream == NULL)
+        return NULL;
+    stream->token = (char*) (stream + 1);
+    memcpy(stream->token, token, token_len);
+    stream->token_len = token_len;
+    stream->err = CSPLIT_SUCCESS;
+    return stream;
+}
+
+
+/**
+ * @brief Function that frees a streaming splitter and its buffer
+ * @ingroup set
+ *
+ * @params[in]: stream  -> streaming splitter to free
+ */
+_CSPLIT_FUNC
+void csplit_clear_stream(CSplitStream_t* stream){
+    if(stream == NULL)
+        return;
+    csplit_free(stream->carry);
+    csplit_free(stream);
+}
+
+
+/**
+ * @brief Function that appends bytes to the unfinished fragment carried between chunks, growing its buffer by doubling
+ * @ingroup intern
+ *
+ * @params[out]: stream -> streaming splitter
+ * @params[in]: bytes   -> bytes to append
+ * @params[in]: len     -> number of bytes to append
+ * @return: err         -> CSPLIT_BUFF_EXCEEDED if the buffer could not grow
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_stream_append(CSplitStream_t* stream, const char* bytes, size_t len){
+    if(stream->carry_len + len > stream->carry_cap){
+        size_t capacity = stream->carry_cap == 0 ? 64 : stream->carry_cap;
+        while(capacity < stream->carry_len + len)
+            capacity = capacity * 2;
+        char* carry = (char*) csplit_realloc(stream->carry, capacity);
+        if(carry == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+        stream->carry = carry;
+        stream->carry_cap = capacity;
+    }
+    if(len > 0)
+        memcpy(stream->carry + stream->carry_len, bytes, len);
+    CSPLIT_STAT_ADD(bytes_copied, len);
+    stream->carry_len = stream->carry_len + len;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that passes the next chunk of input to a streaming splitter. The chunk is not copied, and must stay
+ * valid until csplit_stream_next returns 0. Fragments are then read with csplit_stream_next.
+ * @ingroup core
+ *
+ * @params[out]: stream     -> streaming splitter
+ * @params[in]: chunk       -> next bytes of the input
+ * @params[in]: chunk_len   -> number of bytes in chunk
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if the previous chunk was not fully consumed, or the stream has ended
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_stream_feed(CSplitStream_t* stream, const char* chunk, size_t chunk_len){
+    if(stream == NULL || (chunk == NULL && chunk_len > 0))
+        return CSPLIT_TOO_SHORT;
+    if(stream->err != CSPLIT_SUCCESS)
+        return stream->err;
+    if(stream->chunk != NULL || stream->finished)
+        return CSPLIT_BUFF_EXCEEDED;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_STREAM);
+    stream->chunk = chunk == NULL ? "" : chunk;
+    stream->chunk_len = chunk_len;
+    // a token can only span the boundary if there is a partial fragment, and the token is longer than a byte
+    stream->joined = stream->carry_len == 0 || stream->token_len == 1;
+    stream->iter_ready = 0;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that signals the end of the input to a streaming splitter. The next calls to csplit_stream_next
+ * return the rest of the current chunk, and then the last fragment, which may be empty.
+ * @ingroup core
+ *
+ * @params[out]: stream     -> streaming splitter
+ */
+_CSPLIT_FUNC
+void csplit_stream_finish(CSplitStream_t* stream){
+    if(stream != NULL)
+        stream->finished = 1;
+}
+
+
+/**
+ * @brief Function that checks for a token that starts in the carried fragment and ends in the new chunk. The first
+ * token_len - 1 bytes of the chunk are appended to the carried fragment for the search, and removed again if no
+ * token was found, so that every byte is searched only once.
+ * @ingroup intern
+ *
+ * @params[out]: stream     -> streaming splitter
+ * @params[out]: fragment   -> receives the carried fragment if a token was found
+ * @return: found           -> 1 if a token ended the carried fragment, 0 if not, or a negative error code
+ */
+_CSPLIT_FUNC
+int csplit_stream_join(CSplitStream_t* stream, CSplitView_t* fragment){
+    size_t carry_len = stream->carry_len;
+    size_t head_len = stream->token_len - 1;
+    CSplitError_t err;
+    const char* found;
+    if(head_len > stream->chunk_len)
+        head_len = stream->chunk_len;
+    err = csplit_stream_append(stream, stream->chunk, head_len);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    found = csplit_find_token(stream->carry + stream->carry_scanned, stream->carry_len - stream->carry_scanned,
+                              stream->token, stream->token_len);
+    stream->carry_len = carry_len;
+    // only a token that starts before the chunk does is found here, the rest is left to the chunk scan
+    if(found == NULL || (size_t) (found - stream->carry) >= carry_len)
+        return 0;
+    fragment->text = stream->carry;
+    fragment->len = found - stream->carry;
+    stream->carry_emitted = 1;
+    // skip the part of the token that lies in the chunk
+    size_t skip = fragment->len + stream->token_len - carry_len;
+    stream->chunk = stream->chunk + skip;
+    stream->chunk_len = stream->chunk_len - skip;
+    return 1;
+}
+
+
+/**
+ * @brief Function that returns the next fragment of a streaming split. Fragments are views, into the current chunk
+ * or into a buffer owned by the stream, and stay valid until the next call with the same stream.
+ * @ingroup core
+ *
+ * @params[out]: stream     -> streaming splitter
+ * @params[out]: fragment   -> receives the next fragment
+ * @return: found           -> 1 if a fragment was returned, 0 if the stream needs more input or has ended, or a negative error code
+ */
+_CSPLIT_FUNC
+int csplit_stream_next(CSplitStream_t* stream, CSplitView_t* fragment){
+    CSplitError_t err;
+    CSplitView_t view;
+    if(stream == NULL || fragment == NULL)
+        return CSPLIT_TOO_SHORT;
+    if(stream->err != CSPLIT_SUCCESS)
+        return stream->err;
+    if(stream->carry_emitted){
+        stream->carry_len = 0;
+        stream->carry_scanned = 0;
+        stream->carry_emitted = 0;
+    }
+    if(stream->chunk != NULL){
+        if(!stream->joined){
+            int found = csplit_stream_join(stream, fragment);
+            stream->joined = 1;
+            if(found != 0){
+                if(found < 0)
+                    stream->err = (CSplitError_t) found;
+                return found;
+            }
+        }
+        if(!stream->iter_ready){
+            csplit_iter_setup(&stream->iter, stream->chunk, stream->chunk_len, stream->token, stream->token_len, PTRDIFF_MAX);
+            stream->iter_ready = 1;
+        }
+        csplit_iter_next(&stream->iter, &view);
+        if(!stream->iter.done && stream->carry_len == 0){
+            *fragment = view;
+            return 1;
+        }
+        // the fragment starts in an earlier chunk, or does not end in this one, so it goes in the buffer
+        err = csplit_stream_append(stream, view.text, view.len);
+        if(err != CSPLIT_SUCCESS){
+            stream->err = err;
+            return err;
+        }
+        if(!stream->iter.done){
+            fragment->text = stream->carry;
+            fragment->len = stream->carry_len;
+            stream->carry_emitted = 1;
+            return 1;
+        }
+        // only the last token_len - 1 bytes may still be the start of a token
+        if(stream->carry_len >= stream->token_len)
+            stream->carry_scanned = stream->carry_len - stream->token_len + 1;
+        stream->chunk = NULL;
+    }
+    if(stream->finished && !stream->done){
+        fragment->text = stream->carry_len > 0 ? stream->carry : "";
+        fragment->len = stream->carry_len;
+        stream->carry_emitted = 1;
+        stream->done = 1;
+        return 1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Function that opens a file to be split into records. Regular files are mapped into memory, so records and
+ * their fields are views into the file itself. Other files, such as pipes, are read in chunks.
+ * @ingroup set
+ *
+ * @params[in]: path            -> path of the file to open
+ * @params[in]: record_token    -> string that ends each record, or NULL for "\n"
+ * @return: file                -> an open file, or NULL if the file could not be opened
+ */
+_CSPLIT_FUNC
+CSplitFile_t* csplit_open_file(const char* path, const char* record_token){
+    if(path == NULL)
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_FILE);
+    if(record_token == NULL)
+        record_token = "\n";
+    size_t token_len = strlen(record_token);
+    if(token_len == 0)
+        return NULL;
+    // the token copy is stored right after the file itself
+    CSplitFile_t* file = (CSplitFile_t*) csplit_calloc(1, sizeof(CSplitFile_t) + token_len);
+    if(file == NULL)
+        return NULL;
+    file->token = (char*) (file + 1);
+    memcpy(file->token, record_token, token_len);
+    file->token_len = token_len;
+
+#ifdef CSPLIT_MMAP
+    struct stat info;
+    file->fd = open(path, O_RDONLY);
+    if(file->fd < 0){
+        csplit_free(file);
+        return NULL;
+    }
+    if(fstat(file->fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 && (uint64_t) info.st_size <= SIZE_MAX){
+        void* data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+        if(data != MAP_FAILED){
+#ifdef MADV_SEQUENTIAL
+            madvise(data, (size_t) info.st_size, MADV_SEQUENTIAL);
+#endif
+            file->data = (const char*) data;
+            file->len = (size_t) info.st_size;
+            csplit_iter_setup(&file->records, file->data, file->len, file->token, file->token_len, PTRDIFF_MAX);
+            return file;
+        }
+    }
+#else
+    file->fp = fopen(path, "rb");
+    if(file->fp == NULL){
+        csplit_free(file);
+        return NULL;
+    }
+#endif
+    // could not map the file, so read it in chunks
+    file->stream = csplit_init_stream(file->token, file->token_len);
+    file->buffer = (char*) csplit_malloc(CSPLIT_FILE_CHUNK_SIZE);
+    if(file->stream == NULL || file->buffer == NULL){
+        csplit_close_file(file);
+        return NULL;
+    }
+    return file;
+}
+
+
+/**
+ * @brief Function that closes a file opened with csplit_open_file. Views into the file are no longer valid afterwards.
+ * @ingroup set
+ *
+ * @params[in]: file    -> file to close
+ */
+_CSPLIT_FUNC
+void csplit_close_file(CSplitFile_t* file){
+    if(file == NULL)
+        return;
+#ifdef CSPLIT_MMAP
+    if(file->data != NULL)
+        munmap((void*) file->data, file->len);
+    close(file->fd);
+#else
+    fclose(file->fp);
+#endif
+    csplit_clear_stream(file->stream);
+    csplit_free(file->buffer);
+    csplit_free(file);
+}
+
+
+/**
+ * @brief Function that reads the next chunk of a file that is not mapped into its buffer
+ * @ingroup intern
+ *
+ * @params[in]: file    -> file to read from
+ * @return: num_read    -> number of bytes read, 0 at the end of the file, or -1 if reading failed
+ */
+_CSPLIT_FUNC
+ptrdiff_t csplit_file_read_chunk(CSplitFile_t* file){
+#ifdef CSPLIT_MMAP
+    ssize_t num_read;
+    do{
+        num_read = read(file->fd, file->buffer, CSPLIT_FILE_CHUNK_SIZE);
+    } while(num_read < 0 && errno == EINTR);
+    return (ptrdiff_t) num_read;
+#else
+    size_t num_read = fread(file->buffer, 1, CSPLIT_FILE_CHUNK_SIZE, file->fp);
+    if(num_read == 0 && ferror(file->fp))
+        return -1;
+    return (ptrdiff_t) num_read;
+#endif
+}
+
+
+/**
+ * @brief Function that returns the next record of a file, without the token that ends it. An empty last record,
+ * left by a token at the very end of the file, is not returned. The record stays valid until the next call.
+ * @ingroup core
+ *
+ * @params[in]: file    -> file opened with csplit_open_file
+ * @params[out]: record -> receives a view of the next record
+ * @return: found       -> 1 if a record was returned, 0 at the end of the file, or a negative error code
+ */
+_CSPLIT_FUNC
+int csplit_file_next_record(CSplitFile_t* file, CSplitView_t* record){
+    if(file == NULL || record == NULL)
+        return CSPLIT_TOO_SHORT;
+    if(file->record_pending){
+        file->record_pending = 0;
+        *record = file->record;
+        return 1;
+    }
+    if(file->data != NULL){
+        if(!csplit_iter_next(&file->records, record))
+            return 0;
+        return file->records.done && record->len == 0 ? 0 : 1;
+    }
+    if(file->stream == NULL)
+        return 0;
+    while(1){
+        int found = csplit_stream_next(file->stream, record);
+        if(found != 0)
+            return found > 0 && file->stream->done && record->len == 0 ? 0 : found;
+        if(file->eof)
+            return 0;
+        ptrdiff_t num_read = csplit_file_read_chunk(file);
+        if(num_read < 0)
+            return CSPLIT_IO_ERROR;
+        if(num_read == 0){
+            file->eof = 1;
+            csplit_stream_finish(file->stream);
+        }
+        else
+            csplit_stream_feed(file->stream, file->buffer, (size_t) num_read);
+    }
+}
+
+
+/**
+ * @brief Function that reads the next record of a file and splits it into fields, like csplit_view_lim does
+ * for a string. An empty record has no fields. If fields is too small, CSPLIT_BUFF_EXCEEDED is returned with the
+ * required number in num_fields, and the same record is split again by the next call.
+ * @ingroup core
+ *
+ * @params[in]: file            -> file opened with csplit_open_file
+ * @params[out]: fields         -> caller owned array that receives the field views, valid until the next call
+ * @params[in]: max_fields      -> number of elements available in fields
+ * @params[out]: num_fields     -> number of fields in the record, even if larger than max_fields
+ * @params[in]: token           -> string on which to split each record
+ * @params[in]: max_splits      -> max number of splits to perform per record. Negative if starting from end of record.
+ * @return: found               -> 1 if a record was split, 0 at the end of the file, or a negative error code
+ */
+_CSPLIT_FUNC
+int csplit_file_next(CSplitFile_t* file, CSplitView_t* fields, size_t max_fields, size_t* num_fields, const char* token, int max_splits){
+    CSplitError_t err;
+    int found;
+    if(file == NULL || num_fields == NULL || token == NULL || token[0] == '\0')
+        return CSPLIT_TOO_SHORT;
+    *num_fields = 0;
+    found = csplit_file_next_record(file, &file->record);
+    if(found <= 0 || file->record.len == 0)
+        return found;
+    err = csplit_view_lim_n(fields, max_fields, num_fields, file->record.text, file->record.len, token, strlen(token), max_splits);
+    if(err != CSPLIT_SUCCESS){
+        file->record_pending = 1;
+        return err;
+    }
+    return 1;
+}
+
+
+#ifdef CSPLIT_THREADS
+/**
+ * @brief Function that records the offset of a token found by a parallel split chunk
+ * @ingroup intern
+ *
+ * @params[out]: chunk  -> chunk that found the token
+ * @params[in]: offset  -> offset of the token in the input
+ * @return: err         -> CSPLIT_BUFF_EXCEEDED if the offsets could not grow
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel_push_match(CSplitParallelChunk_t* chunk, size_t offset){
+    if(chunk->num_matches == chunk->capacity){
+        size_t new_capacity = chunk->capacity == 0 ? 64 : chunk->capacity * 2;
+        size_t* new_matches = (size_t*) csplit_realloc(chunk->matches, new_capacity * sizeof(size_t));
+        if(new_matches == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+        chunk->matches = new_matches;
+        chunk->capacity = new_capacity;
+    }
+    chunk->matches[chunk->num_matches] = offset;
+    chunk->num_matches++;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Thread function that finds the tokens starting in one chunk of a parallel split, scanning left to right
+ * from the start of the chunk. Tokens may end past the end of the chunk.
+ * @ingroup intern
+ *
+ * @params[in]: arg     -> the CSplitParallelChunk_t to scan
+ * @return: NULL
+ */
+_CSPLIT_FUNC
+void* csplit_parallel_find(void* arg){
+    CSplitParallelChunk_t* chunk = (CSplitParallelChunk_t*) arg;
+    CSplitIter_t iter;
+    CSplitView_t view;
+    // only tokens that start before the end of the chunk fit in the scanned range
+    size_t scan_end = chunk->end + chunk->token_len - 1;
+    if(scan_end > chunk->len)
+        scan_end = chunk->len;
+    csplit_iter_setup(&iter, chunk->data + chunk->begin, scan_end - chunk->begin, chunk->token, chunk->token_len, PTRDIFF_MAX);
+    while(chunk->err == CSPLIT_SUCCESS && csplit_iter_next(&iter, &view) && !iter.done)
+        chunk->err = csplit_parallel_push_match(chunk, (size_t) (view.text + view.len - chunk->data));
+    return NULL;
+}
+
+
+/**
+ * @brief Thread function that copies out the fragments ending in one chunk of a parallel split, into the chunk's
+ * list, or as views into the chunk's part of the output array.
+ * @ingroup intern
+ *
+ * @params[in]: arg     -> the CSplitParallelChunk_t to copy
+ * @return: NULL
+ */
+_CSPLIT_FUNC
+void* csplit_parallel_copy(void* arg){
+    CSplitParallelChunk_t* chunk = (CSplitParallelChunk_t*) arg;
+    size_t num_fragments = chunk->num_matches + (chunk->last ? 1 : 0);
+    size_t start = chunk->frag_begin;
+    size_t i;
+    for(i = 0; i < num_fragments && chunk->err == CSPLIT_SUCCESS; i++){
+        size_t stop = i < chunk->num_matches ? chunk->matches[i] : chunk->len;
+        CSplitView_t view;
+        view.text = chunk->data + start;
+        view.len = stop - start;
+        if(chunk->list != NULL)
+            chunk->err = csplit_push_view_to_list(chunk->list, &view);
+        else
+            chunk->views[i] = view;
+        start = stop + chunk->token_len;
+    }
+    return NULL;
+}
+
+
+#ifdef CSPLIT_STATS
+/**
+ * @brief Thread function that runs the work of a chunk on a helper thread, and then saves the counters of that
+ * thread into the chunk, since they are lost when it exits
+ * @ingroup intern
+ *
+ * @params[in]: arg     -> the CSplitParallelChunk_t to process
+ * @return: NULL
+ */
+_CSPLIT_FUNC
+void* csplit_parallel_worker(void* arg){
+    CSplitParallelChunk_t* chunk = (CSplitParallelChunk_t*) arg;
+    chunk->work(arg);
+    chunk->stats = csplit_stats;
+    return NULL;
+}
+#endif
+
+
+/**
+ * @brief Function that runs a thread function on every chunk of a parallel split, one thread per chunk. The calling
+ * thread handles the first chunk, and any chunk for which a thread could not be started. With CSPLIT_STATS, the
+ * counters of the helper threads are added to those of the calling thread.
+ * @ingroup intern
+ *
+ * @params[in]: chunks      -> chunks to process
+ * @params[in]: num_chunks  -> number of chunks
+ * @params[in]: work        -> thread function, called with a pointer to a chunk
+ */
+_CSPLIT_FUNC
+void csplit_parallel_run(CSplitParallelChunk_t* chunks, size_t num_chunks, void* (*work)(void*)){
+    pthread_t* threads = (pthread_t*) csplit_malloc(num_chunks * sizeof(pthread_t));
+    char* started = (char*) csplit_calloc(num_chunks, 1);
+    size_t i;
+    for(i = 1; i < num_chunks; i++){
+#ifdef CSPLIT_STATS
+        chunks[i].work = work;
+        if(threads != NULL && started != NULL)
+            started[i] = pthread_create(&threads[i], NULL, csplit_parallel_worker, &chunks[i]) == 0;
+#else
+        if(threads != NULL && started != NULL)
+            started[i] = pthread_create(&threads[i], NULL, work, &chunks[i]) == 0;
+#endif
+    }
+    work(&chunks[0]);
+    for(i = 1; i < num_chunks; i++){
+        if(started != NULL && started[i]){
+            pthread_join(threads[i], NULL);
+#ifdef CSPLIT_STATS
+            csplit_add_stats(&csplit_stats, &chunks[i].stats);
+#endif
+        }
+        else
+            work(&chunks[i]);
+    }
+    csplit_free(threads);
+    csplit_free(started);
+}
+
+
+/**
+ * @brief Function that corrects the tokens found by a chunk, when a token found by the previous chunks ends inside
+ * it. The chunk is scanned again from the end of that token, only until a token it already found is reached.
+ * Past that point a left to right scan finds the same tokens, so the rest are kept.
+ * @ingroup intern
+ *
+ * @params[out]: chunk  -> chunk to correct
+ * @params[in]: next    -> offset at which a single left to right scan would resume, after the previous chunks
+ * @return: err         -> CSPLIT_BUFF_EXCEEDED if memory could not be allocated
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel_stitch(CSplitParallelChunk_t* chunk, size_t next){
+    CSplitParallelChunk_t fixed;
+    size_t scan_end = chunk->end + chunk->token_len - 1;
+    size_t i = 0;
+    int synced = 0;
+    if(scan_end > chunk->len)
+        scan_end = chunk->len;
+    memset(&fixed, 0, sizeof(fixed));
+    while(next < scan_end){
+        const char* found = csplit_find_token(chunk->data + next, scan_end - next, chunk->token, chunk->token_len);
+        if(found == NULL)
+            break;
+        size_t offset = (size_t) (found - chunk->data);
+        while(i < chunk->num_matches && chunk->matches[i] < offset)
+            i++;
+        if(i < chunk->num_matches && chunk->matches[i] == offset){
+            synced = 1;
+            break;
+        }
+        if(csplit_parallel_push_match(&fixed, offset) != CSPLIT_SUCCESS){
+            csplit_free(fixed.matches);
+            return CSPLIT_BUFF_EXCEEDED;
+        }
+        next = offset + chunk->token_len;
+    }
+    // if the scan stopped without reaching a known token, none of the old ones are real
+    if(!synced)
+        i = chunk->num_matches;
+    for(; i < chunk->num_matches; i++){
+        if(csplit_parallel_push_match(&fixed, chunk->matches[i]) != CSPLIT_SUCCESS){
+            csplit_free(fixed.matches);
+            return CSPLIT_BUFF_EXCEEDED;
+        }
+    }
+    csplit_free(chunk->matches);
+    chunk->matches = fixed.matches;
+    chunk->num_matches = fixed.num_matches;
+    chunk->capacity = fixed.capacity;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that picks the number of chunks for a parallel split, giving each thread at least
+ * CSPLIT_PARALLEL_MIN_CHUNK bytes
+ * @ingroup intern
+ *
+ * @params[in]: len         -> length of the input
+ * @params[in]: num_threads -> requested number of threads, or 0 for the number of online processors
+ * @return: num_chunks      -> number of chunks to split the input into
+ */
+_CSPLIT_FUNC
+size_t csplit_parallel_num_chunks(size_t len, int num_threads){
+    size_t num_chunks;
+    if(num_threads <= 0){
+        long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = num_cpus > 0 ? (int) num_cpus : 1;
+    }
+    num_chunks = len / CSPLIT_PARALLEL_MIN_CHUNK;
+    if(num_chunks > (size_t) num_threads)
+        num_chunks = (size_t) num_threads;
+    return num_chunks == 0 ? 1 : num_chunks;
+}
+
+
+/**
+ * @brief Function that finds every token of the input in parallel, and corrects the chunk edges, so that the tokens
+ * found are those a single left to right scan would find.
+ * @ingroup intern
+ *
+ * @params[in]: data            -> input which will be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: num_chunks      -> number of chunks to split the input into
+ * @params[out]: num_fragments  -> total number of fragments produced by the split
+ * @return: chunks              -> allocated chunks, to be freed with csplit_parallel_free, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+CSplitParallelChunk_t* csplit_parallel_find_all(const char* data, size_t len, const char* token, size_t token_len, size_t num_chunks, size_t* num_fragments){
+    CSplitParallelChunk_t* chunks = (CSplitParallelChunk_t*) csplit_calloc(num_chunks, sizeof(CSplitParallelChunk_t));
+    size_t next = 0;
+    size_t i;
+    if(chunks == NULL)
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_PARALLEL);
+    for(i = 0; i < num_chunks; i++){
+        chunks[i].data = data;
+        chunks[i].len = len;
+        chunks[i].token = token;
+        chunks[i].token_len = token_len;
+        chunks[i].begin = len / num_chunks * i;
+        chunks[i].end = i + 1 == num_chunks ? len : len / num_chunks * (i + 1);
+        chunks[i].last = i + 1 == num_chunks;
+        chunks[i].err = CSPLIT_SUCCESS;
+    }
+    csplit_parallel_run(chunks, num_chunks, csplit_parallel_find);
+
+    *num_fragments = 1;
+    for(i = 0; i < num_chunks; i++){
+        if(chunks[i].err != CSPLIT_SUCCESS || (next > chunks[i].begin && csplit_parallel_stitch(&chunks[i], next) != CSPLIT_SUCCESS)){
+            csplit_parallel_free(chunks, num_chunks);
+            return NULL;
+        }
+        chunks[i].frag_begin = next;
+        if(chunks[i].num_matches > 0)
+            next = chunks[i].matches[chunks[i].num_matches - 1] + token_len;
+        *num_fragments = *num_fragments + chunks[i].num_matches;
+    }
+    return chunks;
+}
+
+
+/**
+ * @brief Function that frees the chunks of a parallel split
+ * @ingroup intern
+ *
+ * @params[in]: chunks      -> chunks to free
+ * @params[in]: num_chunks  -> number of chunks
+ */
+_CSPLIT_FUNC
+void csplit_parallel_free(CSplitParallelChunk_t* chunks, size_t num_chunks){
+    size_t i;
+    for(i = 0; i < num_chunks; i++){
+        csplit_free(chunks[i].matches);
+        if(chunks[i].list != NULL)
+            csplit_clear_list(chunks[i].list);
+    }
+    csplit_free(chunks);
+}
+
+
+/**
+ * @brief Version of csplit_n that splits the input on several threads. The input is cut into one chunk per thread,
+ * tokens are found in every chunk at once, and the fragments are copied out at once. The resulting list is the same
+ * as the one csplit_n makes. Arena backed lists, and lists with their own allocator, are filled by the calling thread,
+ * since neither the arena nor a user allocator can be assumed to be thread safe. Fragments kept by csplit_reset_list
+ * are reused.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting data on token
+ * @params[in]: data            -> input which will be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: num_threads     -> max number of threads to use, or 0 for one per online processor
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parallel(CSplitList_t* list, const char* data, size_t len, const char* token, size_t token_len, int num_threads){
+    CSplitError_t err = CSPLIT_SUCCESS;
+    size_t num_chunks = csplit_parallel_num_chunks(len, num_threads);
+    size_t num_fragments;
+    size_t i;
+    if(list == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    if(num_chunks == 1)
+        return csplit_lim_n(list, data, len, token, token_len, PTRDIFF_MAX);
+
+    CSplitParallelChunk_t* chunks = csplit_parallel_find_all(data, len, token, token_len, num_chunks, &num_fragments);
+    if(chunks == NULL)
+        return CSPLIT_BUFF_EXCEEDED;
+    if(num_fragments > (size_t) (INT_MAX - list->num_elems)){
+        csplit_parallel_free(chunks, num_chunks);
+        return CSPLIT_BUFF_EXCEEDED;
+    }
+    if(list->arena != NULL || list->allocator.alloc != NULL){
+        for(i = 0; i < num_chunks && err == CSPLIT_SUCCESS; i++){
+            chunks[i].list = list;
+            csplit_parallel_copy(&chunks[i]);
+            chunks[i].list = NULL;
+            err = chunks[i].err;
+        }
+        csplit_parallel_free(chunks, num_chunks);
+        return err;
+    }
+
+    // each chunk copies its fragments into its own list, and the lists are linked together in order
+    for(i = 0; i < num_chunks; i++){
+        chunks[i].list = csplit_init_list();
+        if(chunks[i].list == NULL){
+            csplit_parallel_free(chunks, num_chunks);
+            return CSPLIT_BUFF_EXCEEDED;
+        }
+        // fragments kept by csplit_reset_list are shared out, so each chunk reuses them before allocating
+        size_t needed = chunks[i].num_matches + (chunks[i].last ? 1 : 0);
+        while(needed > 0 && list->spare != NULL){
+            CSplitFragment_t* fragment = list->spare;
+            list->spare = fragment->next;
+            fragment->next = chunks[i].list->spare;
+            chunks[i].list->spare = fragment;
+            needed--;
+        }
+    }
+    csplit_parallel_run(chunks, num_chunks, csplit_parallel_copy);
+    for(i = 0; i < num_chunks && err == CSPLIT_SUCCESS; i++){
+        CSplitList_t* part = chunks[i].list;
+        err = chunks[i].err;
+        if(part->head != NULL){
+            if(list->head == NULL)
+                list->head = part->head;
+            else{
+                list->tail->next = part->head;
+                part->head->prev = list->tail;
+            }
+            list->tail = part->tail;
+            list->num_elems = list->num_elems + part->num_elems;
+            part->head = NULL;
+            part->tail = NULL;
+            part->num_elems = 0;
+        }
+    }
+    csplit_parallel_free(chunks, num_chunks);
+    return err;
+}
+
+
+/**
+ * @brief Version of csplit_array_lim_n that splits the input on several threads, appending every fragment to the
+ * array. The resulting views are the same as the ones csplit_array_lim_n makes when splitting on every token.
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting data on token
+ * @params[in]: data            -> input which will be split. Views point into it.
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: num_threads     -> max number of threads to use, or 0 for one per online processor
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_parallel(CSplitArray_t* array, const char* data, size_t len, const char* token, size_t token_len, int num_threads){
+    size_t num_chunks = csplit_parallel_num_chunks(len, num_threads);
+    size_t num_fragments;
+    size_t i;
+    if(array == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    if(num_chunks == 1)
+        return csplit_array_lim_n(array, data, len, token, token_len, PTRDIFF_MAX);
+
+    CSplitParallelChunk_t* chunks = csplit_parallel_find_all(data, len, token, token_len, num_chunks, &num_fragments);
+    if(chunks == NULL)
+        return CSPLIT_BUFF_EXCEEDED;
+    // appending to the logical end of a reversed array requires storing it in order first
+    if(array->reversed){
+        csplit_reverse_views(array->elems, array->num_elems);
+        array->reversed = 0;
+    }
+    if(array->num_elems + num_fragments > array->capacity){
+        CSplitView_t* new_elems = (CSplitView_t*) csplit_realloc(array->elems, (array->num_elems + num_fragments) * sizeof(CSplitView_t));
+        if(new_elems == NULL){
+            csplit_parallel_free(chunks, num_chunks);
+            return CSPLIT_BUFF_EXCEEDED;
+        }
+        array->elems = new_elems;
+        array->capacity = array->num_elems + num_fragments;
+    }
+    // every chunk writes its views straight into its own part of the array
+    CSplitView_t* views = array->elems + array->num_elems;
+    for(i = 0; i < num_chunks; i++){
+        chunks[i].views = views;
+        views = views + chunks[i].num_matches;
+    }
+    csplit_parallel_run(chunks, num_chunks, csplit_parallel_copy);
+    array->num_elems = array->num_elems + num_fragments;
+    csplit_parallel_free(chunks, num_chunks);
+    return CSPLIT_SUCCESS;
+}
+#endif
+
+
+/**
+ * @brief Function that calls a function on each fragment of a split, without allocating or copying anything.
+ * Fragments are passed in the order they are found, so a reverse split passes the last fragment first.
+ * @ingroup core
+ *
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @params[in]: callback        -> function called with each fragment. Returning nonzero stops the split
+ * @params[in]: user_data       -> pointer passed to every call of callback
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_foreach(const char* input_str, const char* token, int max_splits, CSplitCallback_t callback, void* user_data){
+    CSplitIter_t iter;
+    CSplitView_t fragment;
+    if(callback == NULL)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_FOREACH);
+    CSplitError_t err = csplit_iter_init(&iter, input_str, token, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    while(csplit_iter_next(&iter, &fragment)){
+        if(callback(&fragment, user_data) != 0)
+            break;
+    }
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Version of csplit_iter_init that splits on any byte of a set of delimiters
+ * @ingroup core
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input_str   -> input string which will be split. Must outlive the iterator
+ * @params[in]: set         -> set compiled with csplit_compile_charset. Must outlive the iterator
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ * @return: err             -> CSPLIT_TOO_SHORT if the input is empty, in which case the iterator returns nothing
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_charset(CSplitIter_t* iter, const char* input_str, const CSplitCharset_t* set, int max_splits){
+    if(iter == NULL)
+        return CSPLIT_TOO_SHORT;
+    if(input_str == NULL || set == NULL || input_str[0] == '\0'){
+        memset(iter, 0, sizeof(CSplitIter_t));
+        iter->done = 1;
+        return CSPLIT_TOO_SHORT;
+    }
+    CSPLIT_STAT_CALL(CSPLIT_CALL_ITER);
+    csplit_iter_setup_charset(iter, input_str, strlen(input_str), set, max_splits);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Version of csplit_lim that splits on any byte of a set of delimiters, like strsep does. Every delimiter
+ * counts as one split, so neighboring delimiters leave an empty fragment between them.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting input str on the delimiters
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: set             -> set compiled with csplit_compile_charset
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_charset(CSplitList_t* list, const char* input_str, const CSplitCharset_t* set, int max_splits){
+    CSplitIter_t iter;
+    CSplitError_t err = csplit_iter_init_charset(&iter, input_str, set, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+/**
+ * @brief Zero-copy version of csplit_charset, filling an array of views like csplit_view_lim
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: set             -> set compiled with csplit_compile_charset
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_charset(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, const CSplitCharset_t* set, int max_splits){
+    CSplitIter_t iter;
+    *num_views = 0;
+    CSplitError_t err = csplit_iter_init_charset(&iter, input_str, set, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_views_from_iter(views, max_views, num_views, &iter);
+}
+
+
+/**
+ * @brief Version of csplit_charset that appends views to a csplit array
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on the delimiters
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: set             -> set compiled with csplit_compile_charset
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_charset(CSplitArray_t* array, const char* input_str, const CSplitCharset_t* set, int max_splits){
+    CSplitIter_t iter;
+    if(array == NULL)
+        return CSPLIT_TOO_SHORT;
+    CSplitError_t err = csplit_iter_init_charset(&iter, input_str, set, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_array_from_iter(array, &iter);
+}
+
+
+/**
+ * @brief Function that splits on any character of a string, building the set of delimiters on each call.
+ * Use csplit_compile_charset and csplit_charset to split many strings on the same set.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting input str on the delimiters
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: chars           -> string holding every delimiter
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_any(CSplitList_t* list, const char* input_str, const char* chars, int max_splits){
+    CSplitCharset_t set;
+    CSplitError_t err = csplit_compile_charset(&set, chars);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_charset(list, input_str, &set, max_splits);
+}
+
+
+/**
+ * @brief Version of csplit_iter_init that splits on runs of whitespace, like str.split() in python
+ * @ingroup core
+ *
+ * @params[out]: iter       -> iterator to initialize
+ * @params[in]: input_str   -> input string which will be split. Must outlive the iterator
+ * @params[in]: max_splits  -> max number of splits to perform. Negative if starting from end of string.
+ * @return: err             -> CSPLIT_TOO_SHORT if the input is NULL, in which case the iterator returns nothing
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_iter_init_whitespace(CSplitIter_t* iter, const char* input_str, int max_splits){
+    if(iter == NULL)
+        return CSPLIT_TOO_SHORT;
+    if(input_str == NULL){
+        memset(iter, 0, sizeof(CSplitIter_t));
+        iter->done = 1;
+        return CSPLIT_TOO_SHORT;
+    }
+    CSPLIT_STAT_CALL(CSPLIT_CALL_ITER);
+    csplit_iter_setup_whitespace(iter, input_str, strlen(input_str), max_splits);
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that splits on runs of whitespace, like str.split() with no separator in python. Any run of
+ * ' ', '\t', '\n', '\v', '\f' and '\r' is one separator, and whitespace at the start and end is ignored, so
+ * there are no empty fragments. Input that is empty or all whitespace gives no fragments.
+ * @ingroup core
+ *
+ * @params[out]: list           -> output list splitting input str on whitespace
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_whitespace(CSplitList_t* list, const char* input_str, int max_splits){
+    CSplitIter_t iter;
+    CSplitError_t err = csplit_iter_init_whitespace(&iter, input_str, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_list_from_iter(list, &iter);
+}
+
+
+/**
+ * @brief Zero-copy version of csplit_whitespace, filling an array of views like csplit_view_lim
+ * @ingroup core
+ *
+ * @params[out]: views          -> caller owned array that receives the fragment views, in input order
+ * @params[in]: max_views       -> number of elements available in views
+ * @params[out]: num_views      -> number of fragments produced by the split, even if larger than max_views
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_view_whitespace(CSplitView_t* views, size_t max_views, size_t* num_views, const char* input_str, int max_splits){
+    CSplitIter_t iter;
+    *num_views = 0;
+    CSplitError_t err = csplit_iter_init_whitespace(&iter, input_str, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_views_from_iter(views, max_views, num_views, &iter);
+}
+
+
+/**
+ * @brief Version of csplit_whitespace that appends views to a csplit array
+ * @ingroup core
+ *
+ * @params[out]: array          -> output array splitting input str on whitespace
+ * @params[in]: input_str       -> input string which will be split. Views point into it.
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return:     err             -> error code if there was a problem with csplitting.
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_array_whitespace(CSplitArray_t* array, const char* input_str, int max_splits){
+    CSplitIter_t iter;
+    if(array == NULL)
+        return CSPLIT_TOO_SHORT;
+    CSplitError_t err = csplit_iter_init_whitespace(&iter, input_str, max_splits);
+    if(err != CSPLIT_SUCCESS)
+        return err;
+    return csplit_array_from_iter(array, &iter);
+}
+
+
+/**
+ * @brief Function that returns the index of the lowest set bit of a nonzero 64 bit mask
+ * @ingroup intern
+ *
+ * @params[in]: mask    -> nonzero bitmask
+ * @return: index       -> index of the lowest set bit
+ */
+_CSPLIT_FUNC
+unsigned int csplit_ctz64(uint64_t mask){
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    if(_BitScanForward(&index, (unsigned long) mask))
+        return (unsigned int) index;
+    _BitScanForward(&index, (unsigned long) (mask >> 32));
+    return (unsigned int) index + 32;
+#else
+    return (unsigned int) __builtin_ctzll(mask);
+#endif
+}
+
+
+/**
+ * @brief Function that computes the prefix XOR of a mask, so bit i of the result is the XOR of bits 0 to i.
+ * Applied to the quotes of a block, it sets the bits that are inside quotes.
+ * @ingroup intern
+ *
+ * @params[in]: mask    -> bitmask
+ * @return: prefix      -> prefix XOR of mask
+ */
+_CSPLIT_FUNC
+uint64_t csplit_prefix_xor(uint64_t mask){
+#ifdef CSPLIT_CLMUL
+    // carry-less multiplication by all ones XORs every bit into all the bits above it
+    __m128i product = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long) mask), _mm_set1_epi8((char) 0xFF), 0);
+    return (uint64_t) _mm_cvtsi128_si64(product);
+#else
+    mask = mask ^ (mask << 1);
+    mask = mask ^ (mask << 2);
+    mask = mask ^ (mask << 4);
+    mask = mask ^ (mask << 8);
+    mask = mask ^ (mask << 16);
+    mask = mask ^ (mask << 32);
+    return mask;
+#endif
+}
+
+
+/**
+ * @brief Function that finds the delimiters and newlines outside quotes in the 64 byte block at csv->block_off.
+ * Each quote flips between inside and outside, so a doubled quote leaves the state as it was.
+ * @ingroup intern
+ *
+ * @params[in/out]: csv -> parser whose structural mask and quote state are updated
+ */
+_CSPLIT_FUNC
+void csplit_csv_classify(CSplitCsv_t* csv){
+    const char* block = csv->data + csv->block_off;
+    size_t block_len = csv->len - csv->block_off;
+    uint64_t quotes = 0;
+    uint64_t separators = 0;
+    size_t i;
+    if(block_len > 64)
+        block_len = 64;
+#ifdef CSPLIT_SIMD_WIDTH
+    for(i = 0; i < block_len; i += CSPLIT_SIMD_WIDTH){
+        size_t part_len = block_len - i < CSPLIT_SIMD_WIDTH ? block_len - i : CSPLIT_SIMD_WIDTH;
+        quotes = quotes | ((uint64_t) csplit_byte_mask(block + i, part_len, '"') << i);
+        separators = separators | ((uint64_t) csplit_byte_mask(block + i, part_len, csv->delimiter) << i)
+                                | ((uint64_t) csplit_byte_mask(block + i, part_len, '\n') << i);
+    }
+#else
+    for(i = 0; i < block_len; i++){
+        if(block[i] == '"')
+            quotes = quotes | ((uint64_t) 1 << i);
+        else if(block[i] == csv->delimiter || block[i] == '\n')
+            separators = separators | ((uint64_t) 1 << i);
+    }
+#endif
+    uint64_t inside = csplit_prefix_xor(quotes) ^ csv->in_quote;
+    csv->in_quote = (uint64_t) 0 - (inside >> 63);
+    csv->structural = separators & ~inside;
+    csv->block_ready = 1;
+}
+
+
+/**
+ * @brief Function that returns the offset of the next delimiter or newline outside quotes
+ * @ingroup intern
+ *
+ * @params[in/out]: csv -> parser to advance
+ * @return: offset      -> offset of the byte found, or the input length if there is none
+ */
+_CSPLIT_FUNC
+size_t csplit_csv_next_structural(CSplitCsv_t* csv){
+    while(csv->structural == 0){
+        if(csv->block_ready)
+            csv->block_off = csv->block_off + 64;
+        csv->block_ready = 0;
+        if(csv->block_off >= csv->len)
+            return csv->len;
+        csplit_csv_classify(csv);
+    }
+    size_t offset = csv->block_off + csplit_ctz64(csv->structural);
+    csv->structural = csv->structural & (csv->structural - 1);
+    return offset;
+}
+
+
+/**
+ * @brief Function that copies the contents of a quoted field, turning each doubled quote into one quote
+ * @ingroup intern
+ *
+ * @params[out]: output -> buffer receiving the field, at least len bytes
+ * @params[in]: field   -> contents of the field, without the surrounding quotes
+ * @params[in]: len     -> number of bytes in field
+ * @return: out_len     -> number of bytes written to output
+ */
+_CSPLIT_FUNC
+size_t csplit_csv_unquote(char* output, const char* field, size_t len){
+    size_t out_len = 0;
+    size_t i;
+    for(i = 0; i < len; i++){
+        output[out_len] = field[i];
+        out_len++;
+        if(field[i] == '"' && i + 1 < len && field[i + 1] == '"')
+            i++;
+    }
+    return out_len;
+}
+
+
+/**
+ * @brief Function that prepares a csv parser over an input held in memory, such as a mapped file.
+ * @ingroup core
+ *
+ * @params[out]: csv        -> parser to initialize. Free with csplit_csv_clear
+ * @params[in]: data        -> input to parse. Must outlive the parser
+ * @params[in]: len         -> length of the input
+ * @params[in]: delimiter   -> byte that separates fields, usually ','
+ * @return: err             -> CSPLIT_TOO_SHORT if an argument is NULL, or the delimiter is a quote or newline
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_csv_init(CSplitCsv_t* csv, const char* data, size_t len, char delimiter){
+    if(csv == NULL)
+        return CSPLIT_TOO_SHORT;
+    memset(csv, 0, sizeof(CSplitCsv_t));
+    if(data == NULL || delimiter == '"' || delimiter == '\n')
+        return CSPLIT_TOO_SHORT;
+    csv->data = data;
+    csv->len = len;
+    csv->delimiter = delimiter;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that frees the buffer of a csv parser. The parser may be initialized again afterwards.
+ * @ingroup core
+ *
+ * @params[in]: csv -> parser to clear
+ */
+_CSPLIT_FUNC
+void csplit_csv_clear(CSplitCsv_t* csv){
+    if(csv == NULL)
+        return;
+    csplit_free(csv->unescaped);
+    csv->unescaped = NULL;
+    csv->unescaped_cap = 0;
+}
+
+
+/**
+ * @brief Function that parses the next csv record into fields, following RFC 4180. Quoted fields may hold
+ * delimiters, newlines and doubled quotes, and are returned without their quotes. A "\r\n" ending a record
+ * is treated like "\n", and a blank line is a record with no fields. Fields are views into the input unless they
+ * hold doubled quotes, in which case they point to an unescaped copy owned by the parser. If fields is too
+ * small, CSPLIT_BUFF_EXCEEDED is returned with the required number in num_fields, and the same record is
+ * parsed again by the next call. Quotes in the middle of an unquoted field are not rejected, and still start
+ * or end a quoted region.
+ * @ingroup core
+ *
+ * @params[in]: csv             -> parser prepared with csplit_csv_init
+ * @params[out]: fields         -> caller owned array that receives the field views, valid until the next call
+ * @params[in]: max_fields      -> number of elements available in fields
+ * @params[out]: num_fields     -> number of fields in the record, even if larger than max_fields
+ * @return: found               -> 1 if a record was parsed, 0 at the end of the input, or a negative error code.
+ *                                 CSPLIT_TOO_SHORT if the input ends inside quotes
+ */
+_CSPLIT_FUNC
+int csplit_csv_next(CSplitCsv_t* csv, CSplitView_t* fields, size_t max_fields, size_t* num_fields){
+    CSplitCsv_t saved;
+    size_t start;
+    size_t count = 0;
+    int unescape = 0;
+    if(csv == NULL || num_fields == NULL || (fields == NULL && max_fields > 0))
+        return CSPLIT_TOO_SHORT;
+    *num_fields = 0;
+    if(csv->data == NULL || csv->pos >= csv->len)
+        return 0;
+    saved = *csv;
+    start = csv->pos;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_CSV);
+    while(1){
+        size_t end = csplit_csv_next_structural(csv);
+        if(end == csv->len && csv->in_quote != 0){
+            *csv = saved;
+            return CSPLIT_TOO_SHORT;
+        }
+        int last = end == csv->len || csv->data[end] == '\n';
+        const char* text = csv->data + start;
+        size_t len = end - start;
+        if(last && len > 0 && text[len - 1] == '\r')
+            len--;
+        if(count == 0 && last && len == 0){
+            // a blank line holds no fields
+            csv->pos = end + 1;
+            return 1;
+        }
+        if(count < max_fields){
+            if(len > 0 && text[0] == '"'){
+                text++;
+                len--;
+                if(len > 0 && text[len - 1] == '"')
+                    len--;
+                if(memchr(text, '"', len) != NULL)
+                    unescape = 1;
+            }
+            fields[count].text = text;
+            fields[count].len = len;
+        }
+        count++;
+        start = end + 1;
+        if(last)
+            break;
+    }
+    *num_fields = count;
+    if(count > max_fields){
+        *csv = saved;
+        return CSPLIT_BUFF_EXCEEDED;
+    }
+    if(unescape){
+        // the unescaped fields are never longer than the record, so the buffer only grows before any is written
+        size_t record_len = start - saved.pos;
+        size_t used = 0;
+        size_t i;
+        if(csv->unescaped_cap < record_len){
+            char* new_buffer = (char*) csplit_realloc(csv->unescaped, record_len);
+            if(new_buffer == NULL){
+                *csv = saved;
+                return CSPLIT_BUFF_EXCEEDED;
+            }
+            csv->unescaped = new_buffer;
+            csv->unescaped_cap = record_len;
+        }
+        for(i = 0; i < count; i++){
+            // only quoted fields are unescaped, and the byte before one of them is always its opening quote
+            int quoted = fields[i].text > csv->data && fields[i].text[-1] == '"';
+            if(quoted && memchr(fields[i].text, '"', fields[i].len) != NULL){
+                size_t out_len = csplit_csv_unquote(csv->unescaped + used, fields[i].text, fields[i].len);
+                CSPLIT_STAT_ADD(bytes_copied, out_len);
+                fields[i].text = csv->unescaped + used;
+                fields[i].len = out_len;
+                used = used + out_len;
+            }
+        }
+    }
+    CSPLIT_STAT_ADD(fragments, count);
+    CSPLIT_STAT_ADD(bytes_scanned, start - saved.pos);
+    csv->pos = start;
+    return 1;
+}
+
+
+/**
+ * @brief Function that computes the 64 bit FNV-1a hash of a buffer
+ * @ingroup intern
+ *
+ * @params[in]: data    -> bytes to hash
+ * @params[in]: len     -> number of bytes in data
+ * @return: hash        -> hash of the bytes
+ */
+_CSPLIT_FUNC
+uint64_t csplit_hash(const char* data, size_t len){
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i;
+    for(i = 0; i < len; i++){
+        hash = hash ^ (unsigned char) data[i];
+        hash = hash * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+
+/**
+ * @brief Function that allocates an empty config, in a new arena
+ * @ingroup intern
+ *
+ * @return: config  -> the new config, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_init_config(void){
+    CSplitArenaBlock_t* block = csplit_new_arena(0, sizeof(CSplitConfig_t));
+    if(block == NULL)
+        return NULL;
+    // the config header itself is the first thing stored in the arena
+    CSplitConfig_t* config = (CSplitConfig_t*) (block + 1);
+    memset(config, 0, sizeof(CSplitConfig_t));
+    config->arena = block;
+    if(csplit_config_grow(config) != CSPLIT_SUCCESS){
+        csplit_free_arena(block);
         return NULL;
     }
-    else{
-        // iterate over list until index found
-        int counter = 0;
-        CSplitFragment_t* current_fragment = list->head;
-        while(counter < target_index){
-            current_fragment = current_fragment->next;
-            counter++;
+    return config;
+}
+
+
+/**
+ * @brief Function that doubles the number of slots of a config and reinserts its entries. The old table
+ * stays in the arena, which at most doubles the memory used by tables.
+ * @ingroup intern
+ *
+ * @params[in/out]: config  -> config to grow
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if the table could not be allocated
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_config_grow(CSplitConfig_t* config){
+    size_t new_capacity = config->capacity == 0 ? 64 : config->capacity * 2;
+    size_t i;
+    CSplitConfigEntry_t* new_entries = (CSplitConfigEntry_t*) csplit_arena_push(&config->arena, new_capacity * sizeof(CSplitConfigEntry_t));
+    if(new_entries == NULL)
+        return CSPLIT_BUFF_EXCEEDED;
+    memset(new_entries, 0, new_capacity * sizeof(CSplitConfigEntry_t));
+    for(i = 0; i < config->capacity; i++){
+        if(config->entries[i].key != NULL){
+            size_t slot = (size_t) config->entries[i].hash & (new_capacity - 1);
+            while(new_entries[slot].key != NULL)
+                slot = (slot + 1) & (new_capacity - 1);
+            new_entries[slot] = config->entries[i];
         }
-        // return the text field
-        return current_fragment->text;
+    }
+    config->entries = new_entries;
+    config->capacity = new_capacity;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that stores a copy of a key and value in a config, replacing the value if the key is present
+ * @ingroup intern
+ *
+ * @params[in/out]: config  -> config to add to
+ * @params[in]: key         -> key to store
+ * @params[in]: key_len     -> length of the key
+ * @params[in]: value       -> value to store
+ * @params[in]: value_len   -> length of the value
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if memory could not be allocated
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_config_set(CSplitConfig_t* config, const char* key, size_t key_len, const char* value, size_t value_len){
+    uint64_t hash = csplit_hash(key, key_len);
+    size_t slot;
+    // keep at least half the slots empty, so probes stay short
+    if(2 * (config->num_entries + 1) > config->capacity && csplit_config_grow(config) != CSPLIT_SUCCESS)
+        return CSPLIT_BUFF_EXCEEDED;
+    slot = (size_t) hash & (config->capacity - 1);
+    while(config->entries[slot].key != NULL){
+        CSplitConfigEntry_t* entry = &config->entries[slot];
+        if(entry->hash == hash && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0)
+            break;
+        slot = (slot + 1) & (config->capacity - 1);
+    }
+    CSplitConfigEntry_t* entry = &config->entries[slot];
+    // the key and value share one allocation, and an existing key is kept
+    char* text = (char*) csplit_arena_push(&config->arena, (entry->key == NULL ? key_len + 1 : 0) + value_len + 1);
+    if(text == NULL)
+        return CSPLIT_BUFF_EXCEEDED;
+    CSPLIT_STAT_ADD(bytes_copied, (entry->key == NULL ? key_len : 0) + value_len);
+    if(entry->key == NULL){
+        memcpy(text, key, key_len);
+        text[key_len] = '\0';
+        entry->hash = hash;
+        entry->key = text;
+        entry->key_len = key_len;
+        text = text + key_len + 1;
+        config->num_entries++;
+    }
+    memcpy(text, value, value_len);
+    text[value_len] = '\0';
+    entry->value = text;
+    entry->value_len = value_len;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that parses one line of a config. Blank lines, lines whose first non whitespace character
+ * is '#', and lines without the separator are skipped. Otherwise the key is the text before the first
+ * separator, and the value the text after it, both stripped of whitespace.
+ * @ingroup intern
+ *
+ * @params[in/out]: config      -> config to add the pair to
+ * @params[in]: line            -> line to parse, without its newline
+ * @params[in]: separator       -> string separating the key from the value
+ * @params[in]: separator_len   -> length of the separator
+ * @return: err                 -> CSPLIT_BUFF_EXCEEDED if memory could not be allocated
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_config_parse_line(CSplitConfig_t* config, const CSplitView_t* line, const char* separator, size_t separator_len){
+    CSplitView_t stripped = csplit_strip_view(line->text, line->len);
+    if(stripped.len == 0 || stripped.text[0] == '#')
+        return CSPLIT_SUCCESS;
+    const char* found = csplit_find_token(stripped.text, stripped.len, separator, separator_len);
+    if(found == NULL)
+        return CSPLIT_SUCCESS;
+    CSplitView_t key = csplit_strip_view(stripped.text, (size_t) (found - stripped.text));
+    CSplitView_t value = csplit_strip_view(found + separator_len, stripped.len - (size_t) (found - stripped.text) - separator_len);
+    return csplit_config_set(config, key.text, key.len, value.text, value.len);
+}
+
+
+/**
+ * @brief Function that loads key/value pairs from a config held in memory, one pair per line, such as
+ * "key = value". Blank lines, lines starting with '#', and lines without the separator are skipped, and later
+ * values replace earlier ones for the same key. The config keeps copies, so data may be freed afterwards.
+ * @ingroup core
+ *
+ * @params[in]: data        -> text of the config
+ * @params[in]: len         -> length of the text
+ * @params[in]: separator   -> string separating each key from its value, such as "="
+ * @return: config          -> the loaded config, freed with csplit_clear_config, or NULL on failure
+ */
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_load_config(const char* data, size_t len, const char* separator){
+    CSplitIter_t lines;
+    CSplitView_t line;
+    if(data == NULL || separator == NULL || separator[0] == '\0')
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_CONFIG);
+    CSplitConfig_t* config = csplit_init_config();
+    if(config == NULL)
+        return NULL;
+    size_t separator_len = strlen(separator);
+    csplit_iter_setup(&lines, data, len, "\n", 1, PTRDIFF_MAX);
+    while(csplit_iter_next(&lines, &line)){
+        if(csplit_config_parse_line(config, &line, separator, separator_len) != CSPLIT_SUCCESS){
+            csplit_clear_config(config);
+            return NULL;
+        }
+    }
+    return config;
+}
+
+
+/**
+ * @brief Version of csplit_load_config that reads the config from a file, with csplit_open_file
+ * @ingroup core
+ *
+ * @params[in]: path        -> path of the file to load
+ * @params[in]: separator   -> string separating each key from its value, such as "="
+ * @return: config          -> the loaded config, freed with csplit_clear_config, or NULL on failure
+ */
+_CSPLIT_FUNC
+CSplitConfig_t* csplit_load_config_file(const char* path, const char* separator){
+    CSplitView_t line;
+    int found;
+    if(separator == NULL || separator[0] == '\0')
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_CONFIG);
+    CSplitFile_t* file = csplit_open_file(path, NULL);
+    if(file == NULL)
+        return NULL;
+    CSplitConfig_t* config = csplit_init_config();
+    size_t separator_len = strlen(separator);
+    while(config != NULL && (found = csplit_file_next_record(file, &line)) != 0){
+        if(found < 0 || csplit_config_parse_line(config, &line, separator, separator_len) != CSPLIT_SUCCESS){
+            csplit_clear_config(config);
+            config = NULL;
+        }
+    }
+    csplit_close_file(file);
+    return config;
+}
+
+
+/**
+ * @brief Function that looks up the value of a key of known length in a config
+ * @ingroup core
+ *
+ * @params[in]: config      -> config loaded with csplit_load_config
+ * @params[in]: key         -> key to look up
+ * @params[in]: key_len     -> length of the key
+ * @params[out]: value_len  -> if not NULL, receives the length of the value
+ * @return: value           -> NUL terminated value, valid until the config is cleared, or NULL if the key is missing
+ */
+_CSPLIT_FUNC
+const char* csplit_config_get_n(const CSplitConfig_t* config, const char* key, size_t key_len, size_t* value_len){
+    if(config == NULL || key == NULL)
+        return NULL;
+    uint64_t hash = csplit_hash(key, key_len);
+    size_t slot = (size_t) hash & (config->capacity - 1);
+    while(config->entries[slot].key != NULL){
+        const CSplitConfigEntry_t* entry = &config->entries[slot];
+        if(entry->hash == hash && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0){
+            if(value_len != NULL)
+                *value_len = entry->value_len;
+            return entry->value;
+        }
+        slot = (slot + 1) & (config->capacity - 1);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Function that looks up the value of a key in a config, in constant time
+ * @ingroup core
+ *
+ * @params[in]: config  -> config loaded with csplit_load_config
+ * @params[in]: key     -> key to look up
+ * @return: value       -> NUL terminated value, valid until the config is cleared, or NULL if the key is missing
+ */
+_CSPLIT_FUNC
+const char* csplit_config_get(const CSplitConfig_t* config, const char* key){
+    if(key == NULL)
+        return NULL;
+    return csplit_config_get_n(config, key, strlen(key), NULL);
+}
+
+
+/**
+ * @brief Function that frees a config, along with every key and value in it
+ * @ingroup core
+ *
+ * @params[in]: config  -> config loaded with csplit_load_config
+ */
+_CSPLIT_FUNC
+void csplit_clear_config(CSplitConfig_t* config){
+    if(config != NULL)
+        csplit_free_arena(config->arena);
+}
+
+
+/**
+ * @brief Function that allocates an empty batch result, with room for a number of fragments
+ * @ingroup intern
+ *
+ * @params[in]: num_inputs  -> number of inputs that will be split
+ * @params[in]: capacity    -> number of fragments to make room for
+ * @return: batch           -> the new batch, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_init_batch(size_t num_inputs, size_t capacity){
+    size_t starts_size = (num_inputs + 1) * sizeof(size_t);
+    CSplitBatch_t* batch = (CSplitBatch_t*) csplit_malloc(sizeof(CSplitBatch_t) + starts_size + capacity * sizeof(CSplitView_t));
+    if(batch == NULL)
+        return NULL;
+    batch->starts = (size_t*) (batch + 1);
+    batch->fragments = (CSplitView_t*) ((char*) batch->starts + starts_size);
+    batch->num_fragments = 0;
+    batch->num_inputs = num_inputs;
+    batch->capacity = capacity;
+    batch->starts[0] = 0;
+    return batch;
+}
+
+
+/**
+ * @brief Function that appends a fragment to a batch, doubling its allocation if it is full
+ * @ingroup intern
+ *
+ * @params[in/out]: batch   -> batch to append to, which moves if it is reallocated
+ * @params[in]: text        -> start of the fragment
+ * @params[in]: len         -> length of the fragment
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if the batch could not grow
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_batch_push(CSplitBatch_t** batch, const char* text, size_t len){
+    CSplitBatch_t* current = *batch;
+    if(current->num_fragments == current->capacity){
+        size_t starts_size = (current->num_inputs + 1) * sizeof(size_t);
+        size_t new_capacity = current->capacity < 16 ? 32 : current->capacity * 2;
+        current = (CSplitBatch_t*) csplit_realloc(current, sizeof(CSplitBatch_t) + starts_size + new_capacity * sizeof(CSplitView_t));
+        if(current == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+        current->starts = (size_t*) (current + 1);
+        current->fragments = (CSplitView_t*) ((char*) current->starts + starts_size);
+        current->capacity = new_capacity;
+        *batch = current;
+    }
+    current->fragments[current->num_fragments].text = text;
+    current->fragments[current->num_fragments].len = len;
+    current->num_fragments++;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that splits one input of a batch, appending its fragments and recording where they end
+ * @ingroup intern
+ *
+ * @params[in/out]: batch   -> batch to append to, which moves if it is reallocated
+ * @params[in]: index       -> index of the input in the batch
+ * @params[in]: input       -> input to split, or NULL for an input without fragments
+ * @params[in]: len         -> length of the input
+ * @params[in]: token       -> token on which to split
+ * @params[in]: token_len   -> length of the token
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if the batch could not grow
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_batch_add(CSplitBatch_t** batch, size_t index, const char* input, size_t len, const char* token, size_t token_len){
+    CSplitIter_t iter;
+    CSplitView_t fragment;
+    if(input != NULL){
+        csplit_iter_setup(&iter, input, len, token, token_len, PTRDIFF_MAX);
+        while(csplit_iter_next(&iter, &fragment)){
+            if(csplit_batch_push(batch, fragment.text, fragment.len) != CSPLIT_SUCCESS)
+                return CSPLIT_BUFF_EXCEEDED;
+        }
+    }
+    (*batch)->starts[index + 1] = (*batch)->num_fragments;
+    return CSPLIT_SUCCESS;
+}
+
+
+/**
+ * @brief Function that splits every string of an array on a token, like csplit_view_lim_n with no limit, and
+ * returns all the fragments in one allocation. An empty string gives one empty fragment, and a NULL one none.
+ * @ingroup core
+ *
+ * @params[in]: inputs      -> array of NUL terminated strings to split. Fragments point into them.
+ * @params[in]: num_inputs  -> number of strings in inputs
+ * @params[in]: token       -> string on which to split
+ * @return: batch           -> fragments of every input, freed with csplit_clear_batch, or NULL on failure
+ */
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_batch(const char* const* inputs, size_t num_inputs, const char* token){
+    size_t i;
+    if((inputs == NULL && num_inputs > 0) || token == NULL || token[0] == '\0')
+        return NULL;
+    size_t token_len = strlen(token);
+    CSPLIT_STAT_CALL(CSPLIT_CALL_BATCH);
+    CSplitBatch_t* batch = csplit_init_batch(num_inputs, num_inputs * 4);
+    if(batch == NULL)
+        return NULL;
+    for(i = 0; i < num_inputs; i++){
+        if(csplit_batch_add(&batch, i, inputs[i], inputs[i] == NULL ? 0 : strlen(inputs[i]), token, token_len) != CSPLIT_SUCCESS){
+            csplit_free(batch);
+            return NULL;
+        }
+    }
+    return batch;
+}
+
+
+/**
+ * @brief Version of csplit_batch for inputs stored one after another in a buffer. Input i is the bytes from
+ * data + offsets[i] to data + offsets[i + 1], so offsets has num_inputs + 1 elements, in increasing order.
+ * With a single byte token, the whole buffer is scanned at once, so short inputs still get the SIMD search.
+ * @ingroup core
+ *
+ * @params[in]: data        -> buffer holding the inputs. Fragments point into it.
+ * @params[in]: offsets     -> offset of the start of each input, followed by the end of the last one
+ * @params[in]: num_inputs  -> number of inputs in data
+ * @params[in]: token       -> bytes on which to split
+ * @params[in]: token_len   -> number of bytes in token
+ * @return: batch           -> fragments of every input, freed with csplit_clear_batch, or NULL on failure
+ */
+_CSPLIT_FUNC
+CSplitBatch_t* csplit_batch_n(const char* data, const size_t* offsets, size_t num_inputs, const char* token, size_t token_len){
+    CSplitIter_t iter;
+    CSplitView_t fragment;
+    size_t i;
+    if(data == NULL || offsets == NULL || token == NULL || token_len == 0)
+        return NULL;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_BATCH);
+    CSplitBatch_t* batch = csplit_init_batch(num_inputs, num_inputs * 4);
+    if(batch == NULL)
+        return NULL;
+    if(token_len > 1){
+        // longer tokens could match across the end of an input, so each input is split on its own
+        for(i = 0; i < num_inputs; i++){
+            if(csplit_batch_add(&batch, i, data + offsets[i], offsets[i + 1] - offsets[i], token, token_len) != CSPLIT_SUCCESS){
+                csplit_free(batch);
+                return NULL;
+            }
+        }
+        return batch;
+    }
+
+    // find the tokens of every input in one scan, and close each input once a token lies past its end
+    size_t start = num_inputs > 0 ? offsets[0] : 0;
+    size_t total = num_inputs > 0 ? offsets[num_inputs] - start : 0;
+    const char* fragment_start = data + start;
+    i = 0;
+    csplit_iter_setup(&iter, data + start, total, token, 1, PTRDIFF_MAX);
+    while(i < num_inputs && csplit_iter_next(&iter, &fragment)){
+        const char* found = iter.done ? data + offsets[num_inputs] : fragment.text + fragment.len;
+        while(i < num_inputs && found >= data + offsets[i + 1]){
+            if(csplit_batch_push(&batch, fragment_start, (size_t) (data + offsets[i + 1] - fragment_start)) != CSPLIT_SUCCESS){
+                csplit_free(batch);
+                return NULL;
+            }
+            batch->starts[i + 1] = batch->num_fragments;
+            i++;
+            if(i < num_inputs)
+                fragment_start = data + offsets[i];
+        }
+        if(iter.done || i == num_inputs)
+            break;
+        if(csplit_batch_push(&batch, fragment_start, (size_t) (found - fragment_start)) != CSPLIT_SUCCESS){
+            csplit_free(batch);
+            return NULL;
+        }
+        fragment_start = found + 1;
+    }
+    return batch;
+}
+
+
+/**
+ * @brief Function that returns the fragments of one input of a batch
+ * @ingroup core
+ *
+ * @params[in]: batch           -> batch created by csplit_batch or csplit_batch_n
+ * @params[in]: input           -> index of the input
+ * @params[out]: num_fragments  -> receives the number of fragments of the input
+ * @return: fragments           -> first fragment of the input, or NULL if input is out of range
+ */
+_CSPLIT_FUNC
+const CSplitView_t* csplit_batch_get(const CSplitBatch_t* batch, size_t input, size_t* num_fragments){
+    if(batch == NULL || input >= batch->num_inputs){
+        if(num_fragments != NULL)
+            *num_fragments = 0;
+        return NULL;
+    }
+    if(num_fragments != NULL)
+        *num_fragments = batch->starts[input + 1] - batch->starts[input];
+    return batch->fragments + batch->starts[input];
+}
+
+
+/**
+ * @brief Function that frees a batch. The inputs it points into are not touched.
+ * @ingroup core
+ *
+ * @params[in]: batch   -> batch created by csplit_batch or csplit_batch_n
+ */
+_CSPLIT_FUNC
+void csplit_clear_batch(CSplitBatch_t* batch){
+    csplit_free(batch);
+}
+
+
+#ifdef CSPLIT_STATS
+/**
+ * @brief Function that returns a snapshot of the counters of the calling thread. Work done by the helper threads
+ * of csplit_parallel and csplit_array_parallel is added to the thread that called them.
+ * @ingroup core
+ *
+ * @return: stats   -> copy of the counters
+ */
+_CSPLIT_FUNC
+CSplitStats_t csplit_get_stats(void){
+    return csplit_stats;
+}
+
+
+/**
+ * @brief Function that sets every counter of the calling thread back to zero
+ * @ingroup core
+ */
+_CSPLIT_FUNC
+void csplit_reset_stats(void){
+    memset(&csplit_stats, 0, sizeof(CSplitStats_t));
+}
+
+
+/**
+ * @brief Function that adds one set of counters to another
+ * @ingroup intern
+ *
+ * @params[out]: total  -> counters to add to
+ * @params[in]: part    -> counters to add
+ */
+_CSPLIT_FUNC
+void csplit_add_stats(CSplitStats_t* total, const CSplitStats_t* part){
+    int i;
+    total->allocs = total->allocs + part->allocs;
+    total->bytes_allocated = total->bytes_allocated + part->bytes_allocated;
+    total->bytes_copied = total->bytes_copied + part->bytes_copied;
+    total->bytes_scanned = total->bytes_scanned + part->bytes_scanned;
+    total->fragments = total->fragments + part->fragments;
+    for(i = 0; i < CSPLIT_NUM_CALLS; i++)
+        total->calls[i] = total->calls[i] + part->calls[i];
+}
+
+
+/**
+ * @brief Function that prints the counters of a stats snapshot, one per line
+ * @ingroup core
+ *
+ * @params[in]: stats   -> snapshot from csplit_get_stats
+ * @params[in]: fp      -> file pointer to print to
+ */
+_CSPLIT_FUNC
+void csplit_print_stats(const CSplitStats_t* stats, FILE* fp){
+    static const char* call_names[CSPLIT_NUM_CALLS] = {
+        "list", "view", "array", "iter", "foreach", "stream", "file", "parallel", "csv", "config", "batch",
+        "strip", "remove_whitespace", "parse"
+    };
+    int i;
+    if(stats == NULL || fp == NULL)
+        return;
+    fprintf(fp, "Allocations: %zu\n", stats->allocs);
+    fprintf(fp, "Bytes allocated: %zu\n", stats->bytes_allocated);
+    fprintf(fp, "Bytes copied: %zu\n", stats->bytes_copied);
+    fprintf(fp, "Bytes scanned: %zu\n", stats->bytes_scanned);
+    fprintf(fp, "Fragments: %zu\n", stats->fragments);
+    for(i = 0; i < CSPLIT_NUM_CALLS; i++){
+        if(stats->calls[i] > 0)
+            fprintf(fp, "Calls to %s: %zu\n", call_names[i], stats->calls[i]);
+    }
+}
+#endif
+
+
+/**
+ * @brief Function that allocates memory owned by csplit with CSPLIT_MALLOC
+ * @ingroup intern
+ *
+ * @params[in]: size    -> number of bytes to allocate
+ * @return: ptr         -> uninitialized memory, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+void* csplit_malloc(size_t size){
+    CSPLIT_STAT_ADD(allocs, 1);
+    CSPLIT_STAT_ADD(bytes_allocated, size);
+    return CSPLIT_MALLOC(size);
+}
+
+
+/**
+ * @brief Function that allocates zero filled memory owned by csplit with CSPLIT_CALLOC, or with CSPLIT_MALLOC and
+ * memset if only the other allocator macros were defined
+ * @ingroup intern
+ *
+ * @params[in]: num     -> number of elements to allocate
+ * @params[in]: size    -> size of each element
+ * @return: ptr         -> zero filled memory, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+void* csplit_calloc(size_t num, size_t size){
+    CSPLIT_STAT_ADD(allocs, 1);
+    CSPLIT_STAT_ADD(bytes_allocated, num * size);
+#ifdef CSPLIT_CALLOC
+    return CSPLIT_CALLOC(num, size);
+#else
+    void* ptr;
+    if(size != 0 && num > SIZE_MAX / size)
+        return NULL;
+    ptr = CSPLIT_MALLOC(num * size);
+    if(ptr != NULL)
+        memset(ptr, 0, num * size);
+    return ptr;
+#endif
+}
+
+
+/**
+ * @brief Function that resizes memory owned by csplit with CSPLIT_REALLOC. The whole new size is counted in the
+ * stats, since realloc may have to move the memory.
+ * @ingroup intern
+ *
+ * @params[in]: ptr     -> memory to resize, or NULL
+ * @params[in]: size    -> new size in bytes
+ * @return: ptr         -> resized memory, or NULL if allocation failed, in which case ptr is still valid
+ */
+_CSPLIT_FUNC
+void* csplit_realloc(void* ptr, size_t size){
+    CSPLIT_STAT_ADD(allocs, 1);
+    CSPLIT_STAT_ADD(bytes_allocated, size);
+    return CSPLIT_REALLOC(ptr, size);
+}
+
+
+/**
+ * @brief Function that frees memory owned by csplit with CSPLIT_FREE
+ * @ingroup intern
+ *
+ * @params[in]: ptr     -> memory to free, or NULL
+ */
+_CSPLIT_FUNC
+void csplit_free(void* ptr){
+    CSPLIT_FREE(ptr);
+}
+
+
+/**
+ * @brief Function that allocates memory for a list or its fragments, with the allocator of the list if it has one
+ * @ingroup intern
+ *
+ * @params[in]: list    -> list that will own the memory
+ * @params[in]: size    -> number of bytes to allocate
+ * @return: ptr         -> uninitialized memory, or NULL if allocation failed
+ */
+_CSPLIT_FUNC
+void* csplit_list_alloc(CSplitList_t* list, size_t size){
+    if(list->allocator.alloc == NULL)
+        return csplit_malloc(size);
+    CSPLIT_STAT_ADD(allocs, 1);
+    CSPLIT_STAT_ADD(bytes_allocated, size);
+    return list->allocator.alloc(list->allocator.user_data, size);
+}
+
+
+/**
+ * @brief Function that frees memory allocated with csplit_list_alloc
+ * @ingroup intern
+ *
+ * @params[in]: list    -> list that owns the memory
+ * @params[in]: ptr     -> memory to free, or NULL
+ * @params[in]: size    -> size the memory was allocated with
+ */
+_CSPLIT_FUNC
+void csplit_list_free(CSplitList_t* list, void* ptr, size_t size){
+    if(list->allocator.alloc == NULL)
+        csplit_free(ptr);
+    else if(ptr != NULL){
+        // the allocator is read before the call, as ptr may be the list itself
+        CSplitAllocator_t allocator = list->allocator;
+        allocator.free(allocator.user_data, ptr, size);
     }
 }
 
 
 /**
- * @brief Function that reverses the list generated by csplit
+ * @brief Function for initializing a csplit list whose memory, and that of its fragments, comes from the given
+ * allocator instead of CSPLIT_MALLOC. The allocator is copied into the list, and only called from the thread using
+ * the list, even by csplit_parallel. Fragments pushed with csplit_push_to_list must be allocated with it.
  * @ingroup set
- * 
- * @params[out]: list   -> list to reverse
- * @return: err         -> error code if there is an error
+ *
+ * @params[in]: allocator   -> allocator for the list, or NULL to use CSPLIT_MALLOC
+ * @return: list            -> an allocated csplit list, or NULL if allocation failed or the allocator is incomplete
  */
 _CSPLIT_FUNC
-CSplitError_t csplit_reverse_list(CSplitList_t* list){
-    int i;
-    // iterate over list and swap next and previous fields
-    CSplitFragment_t* temp = list->head;
-    for(i = 0; i < list->num_elems; i++){
-        CSplitFragment_t* temp2 = temp->next;
-        temp->next = temp->prev;
-        temp->prev = temp2;
-        temp = temp2;
+CSplitList_t* csplit_init_allocator_list(const CSplitAllocator_t* allocator){
+    CSplitList_t* list;
+    if(allocator != NULL && (allocator->alloc == NULL || allocator->free == NULL))
+        return NULL;
+    if(allocator == NULL)
+        list = (CSplitList_t*) csplit_malloc(sizeof(CSplitList_t));
+    else{
+        CSPLIT_STAT_ADD(allocs, 1);
+        CSPLIT_STAT_ADD(bytes_allocated, sizeof(CSplitList_t));
+        list = (CSplitList_t*) allocator->alloc(allocator->user_data, sizeof(CSplitList_t));
     }
-    // swap head and tail
-    temp = list->head;
-    list->head = list->tail;
-    list->tail = temp;
-    return CSPLIT_SUCCESS;
+    if(list == NULL)
+        return NULL;
+    memset(list, 0, sizeof(CSplitList_t));
+    if(allocator != NULL)
+        list->allocator = *allocator;
+    return list;
 }
 
 
 /**
- * @brief Function that strips a given string into an output string. Will remove whitespace character:
- * \n, \r, \t, space will be removed from the start and end of each string.
+ * @brief Version of csplit_count for input and token of known length, which may contain NUL characters
  * @ingroup core
- * 
- * @params[in]: input_str   -> the input string to strip
- * @return: output_str      -> the string with whitespace removed from the ends. Must be freed.
+ *
+ * @params[in]: data            -> input which would be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of input.
+ * @params[out]: num_fragments  -> receives the number of fragments
+ * @params[out]: total_bytes    -> if not NULL, receives the size of the buffer csplit_fill_n needs
+ * @return: err                 -> CSPLIT_TOO_SHORT if the input or token is empty
  */
 _CSPLIT_FUNC
-char* csplit_strip(char* input_str){
-    char* output_str;
-    // check if input is null
-    if(input_str == NULL)
-        output_str = NULL;
-    else{
-        int len = strlen(input_str);
-        char* end = input_str + len - 1;
-        char* start = input_str;
-        while(isspace(*start)){
-            if(*start == '\0' || start == end) return NULL;
-            else start++;
-        }
-        while(isspace(*end))
-            end--;
+CSplitError_t csplit_count_n(const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits, size_t* num_fragments, size_t* total_bytes){
+    CSplitIter_t iter;
+    CSplitView_t view;
+    size_t count = 0;
+    if(data == NULL || token == NULL || len == 0 || token_len == 0 || num_fragments == NULL)
+        return CSPLIT_TOO_SHORT;
+    csplit_iter_setup(&iter, data, len, token, token_len, max_splits);
+    while(csplit_iter_next(&iter, &view))
+        count++;
+    *num_fragments = count;
+    // the fragments and the tokens between them cover the whole input, so their total length follows from the count
+    if(total_bytes != NULL)
+        *total_bytes = (count + 1) * sizeof(char*) + len - (count - 1) * token_len + count;
+    return CSPLIT_SUCCESS;
+}
 
-        size_t buff_size = end - start + 1;
-        output_str = (char*) calloc(1, buff_size + 1);
-        strncpy(output_str, start, buff_size);
-    }
-    return output_str;
+
+/**
+ * @brief Function that counts the fragments a split would make, and the size of the single buffer that csplit_fill
+ * needs to hold all of them. Nothing is allocated or copied.
+ * @ingroup core
+ *
+ * @params[in]: input_str       -> input string which would be split
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @params[out]: num_fragments  -> receives the number of fragments
+ * @params[out]: total_bytes    -> if not NULL, receives the size of the buffer csplit_fill needs
+ * @return: err                 -> CSPLIT_TOO_SHORT if the input or token is empty
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_count(const char* input_str, const char* token, int max_splits, size_t* num_fragments, size_t* total_bytes){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_count_n(input_str, strlen(input_str), token, strlen(token), max_splits, num_fragments, total_bytes);
 }
 
 
 /**
- * @breifFunction that removes all whitespace characters of a given string into an output string.
- * Note that resulting char* must be free'd after it is no longer used
+ * @brief Version of csplit_fill for input and token of known length, which may contain NUL characters
  * @ingroup core
- * 
- * @params[in]: input_str   -> the input string to strip
- * @return: output_str      -> the string with whitespace removed.
+ *
+ * @params[out]: output         -> buffer of at least the total_bytes given by csplit_count_n, aligned for a pointer
+ * @params[in]: out_size        -> size of output in bytes
+ * @params[in]: num_fragments   -> number of fragments given by csplit_count_n for the same input, token and max_splits
+ * @params[in]: data            -> input which will be split
+ * @params[in]: len             -> number of bytes in data
+ * @params[in]: token           -> bytes on which to split
+ * @params[in]: token_len       -> number of bytes in token
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of input.
+ * @return: err                 -> CSPLIT_BUFF_EXCEEDED if output is too small or the input has more fragments than
+ *                                 num_fragments, CSPLIT_TOO_SHORT if it has fewer
  */
 _CSPLIT_FUNC
-char* csplit_remove_whitespace(char* input_str){
-    char* output_str;
-    if(input_str == NULL)
-        output_str = NULL;
-    else{
-        int len = strlen(input_str);
-        output_str = (char*) calloc(1, len);
-        int counter = 0;
-        int output_counter = 0;
-        // read through but don't copy whitespace
-        while(counter < len){
-            if(!isspace(input_str[counter])){
-                output_str[output_counter] = input_str[counter];
-                output_counter++;
-            }
-            counter++;
+CSplitError_t csplit_fill_n(char** output, size_t out_size, size_t num_fragments, const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t max_splits){
+    CSplitIter_t iter;
+    CSplitView_t view;
+    size_t count = 0;
+    if(output == NULL || data == NULL || token == NULL || len == 0 || token_len == 0 || num_fragments == 0)
+        return CSPLIT_TOO_SHORT;
+    // tokens never overlap, so there can not be more splits than tokens fitting in the input
+    if(num_fragments - 1 > len / token_len)
+        return CSPLIT_TOO_SHORT;
+    size_t table_size = (num_fragments + 1) * sizeof(char*);
+    size_t text_size = len - (num_fragments - 1) * token_len + num_fragments;
+    if(out_size < table_size || out_size - table_size < text_size)
+        return CSPLIT_BUFF_EXCEEDED;
+
+    // forward splits fill the texts from the front, reverse splits find the last fragment first and fill from the back
+    char* text = (char*) (output + num_fragments + 1);
+    char* text_end = text + text_size;
+    csplit_iter_setup(&iter, data, len, token, token_len, max_splits);
+    while(csplit_iter_next(&iter, &view)){
+        char* dest;
+        if(count == num_fragments || view.len + 1 > (size_t) (text_end - text))
+            return CSPLIT_BUFF_EXCEEDED;
+        if(iter.reverse){
+            text_end = text_end - (view.len + 1);
+            dest = text_end;
+            output[num_fragments - 1 - count] = dest;
+        }
+        else{
+            dest = text;
+            text = text + view.len + 1;
+            output[count] = dest;
         }
+        memcpy(dest, view.text, view.len);
+        dest[view.len] = '\0';
+        CSPLIT_STAT_ADD(bytes_copied, view.len);
+        count++;
     }
-    return output_str;
+    if(count != num_fragments)
+        return CSPLIT_TOO_SHORT;
+    output[num_fragments] = NULL;
+    return CSPLIT_SUCCESS;
 }
 
 
 /**
- * @brief Function that checks if a given string starts with another given string.
+ * @brief Function that splits a string into a single caller owned buffer sized with csplit_count, laid out like argv:
+ * a table of num_fragments pointers followed by a NULL, and then the NUL terminated text of every fragment. Together
+ * with csplit_count, a split needs exactly one allocation, and the result is freed in one call.
  * @ingroup core
- * 
- * @params[in]: input_str       -> string to check against
- * @params[in]: starts_with     -> string to try to match with start of input string
- * @return:     int             -> -2 if input is invalid, -1 if doesn't start with given string, or 0 if it does
+ *
+ * @params[out]: output         -> buffer of at least the total_bytes given by csplit_count, aligned for a pointer
+ * @params[in]: out_size        -> size of output in bytes
+ * @params[in]: num_fragments   -> number of fragments given by csplit_count for the same input, token and max_splits
+ * @params[in]: input_str       -> input string which will be split
+ * @params[in]: token           -> string on which to split
+ * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
+ * @return: err                 -> CSPLIT_BUFF_EXCEEDED if output is too small or the input has more fragments than
+ *                                 num_fragments, CSPLIT_TOO_SHORT if it has fewer
  */
 _CSPLIT_FUNC
-int csplit_startswith(char* input_str, char* starts_with){
-    if(input_str == NULL || starts_with == NULL) return -2;
-    else if(strstr(input_str, starts_with) == input_str) return 0;
-    else return -1;
+CSplitError_t csplit_fill(char** output, size_t out_size, size_t num_fragments, const char* input_str, const char* token, int max_splits){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_fill_n(output, out_size, num_fragments, input_str, strlen(input_str), token, strlen(token), max_splits);
 }
 
 
 /**
- * @brief Function that checks if a given string ends with another given string.
+ * @brief Function that checks if eight bytes loaded into a word are all ascii digits
+ * @ingroup intern
+ *
+ * @params[in]: chunk   -> eight bytes of input, the first in the lowest byte
+ * @return: is_digits   -> 1 if all eight bytes are between '0' and '9', 0 otherwise
+ */
+_CSPLIT_FUNC
+int csplit_is_eight_digits(uint64_t chunk){
+    // digits are 0x30 to 0x39, so their high nibble is 3 both before and after adding 6
+    return ((chunk & UINT64_C(0xF0F0F0F0F0F0F0F0)) |
+            (((chunk + UINT64_C(0x0606060606060606)) & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4)) == UINT64_C(0x3333333333333333);
+}
+
+
+/**
+ * @brief Function that converts eight ascii digits loaded into a word to their value, combining pairs of digits,
+ * then pairs of those, then the two halves
+ * @ingroup intern
+ *
+ * @params[in]: chunk   -> eight digits, the most significant in the lowest byte
+ * @return: value       -> value of the digits, below 100000000
+ */
+_CSPLIT_FUNC
+uint32_t csplit_eight_digits(uint64_t chunk){
+    chunk = ((chunk & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561) >> 8;
+    chunk = ((chunk & UINT64_C(0x00FF00FF00FF00FF)) * 6553601) >> 16;
+    return (uint32_t) (((chunk & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001)) >> 32);
+}
+
+
+/**
+ * @brief Function that parses a field as a base 10 integer with an optional sign. Leading and trailing whitespace
+ * is ignored, anything else that is not a digit makes the field invalid.
  * @ingroup core
- * 
- * @params[in]: input_str       -> string to check against
- * @params[in]: ends_with       -> string to try to match with end of input string
- * @return:     int             -> -2 if input is invalid, -1 if doesn't end with given string, or 0 if it does
+ *
+ * @params[in]: text    -> text of the field, not NUL terminated
+ * @params[in]: len     -> number of bytes in text
+ * @params[out]: value  -> parsed value, 0 if the field is invalid
+ * @return: err         -> CSPLIT_PARSE_ERROR if the field is not an integer, CSPLIT_OUT_OF_RANGE if it does not fit
  */
 _CSPLIT_FUNC
-int csplit_endswith(char* input_str, char* ends_with){
-    if(input_str == NULL || ends_with == NULL){
-        return -2;
+CSplitError_t csplit_view_to_int64(const char* text, size_t len, int64_t* value){
+    const char* cur = text;
+    const char* end = text + len;
+    uint64_t magnitude = 0;
+    int negative = 0;
+    *value = 0;
+    while(cur != end && csplit_is_space(*cur))
+        cur++;
+    while(end != cur && csplit_is_space(end[-1]))
+        end--;
+    if(cur != end && (*cur == '-' || *cur == '+')){
+        negative = (*cur == '-');
+        cur++;
+    }
+    if(cur == end)
+        return CSPLIT_PARSE_ERROR;
+
+#ifdef CSPLIT_LITTLE_ENDIAN
+    while(end - cur >= 8){
+        uint64_t chunk;
+        memcpy(&chunk, cur, 8);
+        if(!csplit_is_eight_digits(chunk))
+            break;
+        // values this large are past INT64_MAX already, so the bound only needs to be conservative
+        if(magnitude > (UINT64_MAX - 99999999) / 100000000)
+            return CSPLIT_OUT_OF_RANGE;
+        magnitude = magnitude * 100000000 + csplit_eight_digits(chunk);
+        cur = cur + 8;
+    }
+#endif
+    while(cur != end){
+        unsigned int digit = (unsigned int) (unsigned char) *cur - '0';
+        if(digit > 9)
+            return CSPLIT_PARSE_ERROR;
+        if(magnitude > (UINT64_MAX - digit) / 10)
+            return CSPLIT_OUT_OF_RANGE;
+        magnitude = magnitude * 10 + digit;
+        cur++;
+    }
+
+    if(negative){
+        if(magnitude > (uint64_t) INT64_MAX + 1)
+            return CSPLIT_OUT_OF_RANGE;
+        *value = (magnitude == (uint64_t) INT64_MAX + 1) ? INT64_MIN : -(int64_t) magnitude;
     }
     else{
-        int ewith_len = strlen(ends_with);
-        int istr_len = strlen(input_str);
-        if(ewith_len > istr_len) return -1;
-        else if(strcmp(input_str + istr_len - ewith_len, ends_with) == 0) return 0;
-        else return -1;
+        if(magnitude > (uint64_t) INT64_MAX)
+            return CSPLIT_OUT_OF_RANGE;
+        *value = (int64_t) magnitude;
     }
+    return CSPLIT_SUCCESS;
 }
 
 
 /**
- * @brief Function that runs csplit on a particular string from the end of the input. Called if max_splits < 0
+ * @brief Function that parses plain decimal numbers whose value is found exactly with one multiplication or
+ * division: at most 19 significant digits, a mantissa no larger than 2^53, and a power of ten no larger than 10^22.
+ * Both are then exact doubles, so the single rounding of the operation gives the correctly rounded result.
  * @ingroup intern
- * 
- * @params[out]: list       -> split input string into this list structure
- * @params[in]: input_str   -> input string
- * @params[in]: token       -> character on which to split
- * @params[in]: max_splits  -> maximum number of splits. If negative will split from end of string
- * @return:     err             -> error code if there was a problem with csplitting.
+ *
+ * @params[in]: cur     -> first byte of the trimmed field
+ * @params[in]: end     -> byte past the end of the trimmed field
+ * @params[out]: value  -> parsed value, if the field was handled
+ * @return: handled     -> 1 if value was set, 0 if the field must be parsed with strtod
  */
 _CSPLIT_FUNC
-CSplitError_t csplit_rstr(CSplitList_t* list, char* input_str, char* token, int max_splits){
-    CSplitError_t err = CSPLIT_SUCCESS;
-    int in_len = strlen(input_str);
-    int counter = 0;
-    int num_splits = 0;
-    int token_len = strlen(token);
-    char* current_location = input_str;
-    char* arr[in_len];
-    while((arr[counter] = strstr(current_location, token)) != NULL){
-        current_location = arr[counter] + 1;
-        counter++;
-    }
-    char* last_location = input_str + in_len;
-    while(counter >= 0 && num_splits >= max_splits){
-        current_location = arr[counter - 1] + token_len;
-        CSplitFragment_t* fragment = (CSplitFragment_t*) calloc(1, sizeof(CSplitFragment_t));
-        size_t req_buff_size;
-        if(num_splits == max_splits || counter == 0){
-            req_buff_size = in_len - strlen(last_location);
-            current_location = input_str;
+int csplit_fast_double(const char* cur, const char* end, double* value){
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int num_digits = 0;
+    int negative = 0;
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD != 0
+    // extended precision intermediates would round twice
+    return 0;
+#endif
+    if(cur != end && (*cur == '-' || *cur == '+')){
+        negative = (*cur == '-');
+        cur++;
+    }
+    while(cur != end && (unsigned int) (unsigned char) *cur - '0' <= 9){
+        if(mantissa >= UINT64_C(1000000000000000000))
+            return 0;
+        mantissa = mantissa * 10 + (unsigned int) (*cur - '0');
+        num_digits++;
+        cur++;
+    }
+    if(cur != end && *cur == '.'){
+        cur++;
+        while(cur != end && (unsigned int) (unsigned char) *cur - '0' <= 9){
+            if(mantissa >= UINT64_C(1000000000000000000))
+                return 0;
+            mantissa = mantissa * 10 + (unsigned int) (*cur - '0');
+            num_digits++;
+            exponent--;
+            cur++;
         }
-        else
-            req_buff_size = last_location - current_location;
-        err = csplit_push_to_list(list, fragment, req_buff_size);
-        strncpy(fragment->text, current_location, req_buff_size);
-        last_location = current_location - token_len;
-        num_splits--;
-        counter--;
-    }
-    err = csplit_reverse_list(list);
-    return err;
+    }
+    if(num_digits == 0)
+        return 0;
+    if(cur != end && (*cur == 'e' || *cur == 'E')){
+        int exp_negative = 0;
+        int exp_value = 0;
+        cur++;
+        if(cur != end && (*cur == '-' || *cur == '+')){
+            exp_negative = (*cur == '-');
+            cur++;
+        }
+        if(cur == end)
+            return 0;
+        while(cur != end && (unsigned int) (unsigned char) *cur - '0' <= 9){
+            if(exp_value > 1000)
+                return 0;
+            exp_value = exp_value * 10 + (*cur - '0');
+            cur++;
+        }
+        exponent = exp_negative ? exponent - exp_value : exponent + exp_value;
+    }
+    if(cur != end || mantissa > (UINT64_C(1) << 53) || exponent < -22 || exponent > 22)
+        return 0;
+
+    *value = (double) mantissa;
+    if(exponent < 0)
+        *value = *value / powers[-exponent];
+    else
+        *value = *value * powers[exponent];
+    if(negative)
+        *value = -*value;
+    return 1;
 }
 
 
 /**
- * @brief Function that splits a given input string based on another string.
- * @ingroup intern
- * 
- * @params[out]: list           -> output list splitting input str on string token
- * @params[in]: input_str       -> input string which will be split
- * @params[in]: token           -> string on which to split
- * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
- * @return:     err             -> error code if there was a problem with csplitting.
+ * @brief Function that parses a field as a double. Leading and trailing whitespace is ignored. Plain decimal numbers
+ * are parsed directly, anything else, such as long mantissas, large exponents, hex, inf or nan, is given to strtod.
+ * @ingroup core
+ *
+ * @params[in]: text    -> text of the field, not NUL terminated
+ * @params[in]: len     -> number of bytes in text
+ * @params[out]: value  -> parsed value, 0 if the field is invalid
+ * @return: err         -> CSPLIT_PARSE_ERROR if the field is not a number, CSPLIT_OUT_OF_RANGE if it overflows a double
  */
 _CSPLIT_FUNC
-CSplitError_t csplit_str(CSplitList_t* list, char* input_str, char* token, int max_splits){
-    if(max_splits < 0)
-        return csplit_rstr(list, input_str, token, max_splits);
+CSplitError_t csplit_view_to_double(const char* text, size_t len, double* value){
+    const char* cur = text;
+    const char* end = text + len;
+    char buffer[64];
+    char* copy = buffer;
+    char* parsed_end;
+    *value = 0;
+    while(cur != end && csplit_is_space(*cur))
+        cur++;
+    while(end != cur && csplit_is_space(end[-1]))
+        end--;
+    if(cur == end)
+        return CSPLIT_PARSE_ERROR;
+    if(csplit_fast_double(cur, end, value))
+        return CSPLIT_SUCCESS;
+
+    // strtod needs a NUL terminated copy, which only fields too long for the stack buffer allocate
+    len = (size_t) (end - cur);
+    if(len >= sizeof(buffer)){
+        copy = (char*) csplit_malloc(len + 1);
+        if(copy == NULL)
+            return CSPLIT_BUFF_EXCEEDED;
+    }
+    memcpy(copy, cur, len);
+    copy[len] = '\0';
+    errno = 0;
+    double result = strtod(copy, &parsed_end);
     CSplitError_t err = CSPLIT_SUCCESS;
-    int in_len = strlen(input_str);
-    int num_splits = 0;
-    int token_len = strlen(token);
-    char* current_location = input_str;
-    char* next_location;
-
-    while(current_location != NULL && num_splits <= max_splits){
-        CSplitFragment_t* fragment = (CSplitFragment_t*) calloc(1, sizeof(CSplitFragment_t));
-        next_location = strstr(current_location, token);
-        size_t req_buff_size;
-        if(next_location == NULL || (num_splits == max_splits))
-            req_buff_size = in_len - (current_location - input_str);
-        else if(next_location != NULL)
-            req_buff_size = next_location - current_location;
-        err = csplit_push_to_list(list, fragment, req_buff_size);
-        strncpy(fragment->text, current_location, req_buff_size);
-        if(next_location != NULL)
-            current_location = next_location + token_len;
-        else{
+    if(parsed_end != copy + len)
+        err = CSPLIT_PARSE_ERROR;
+    else if(errno == ERANGE && (result > DBL_MAX || result < -DBL_MAX))
+        err = CSPLIT_OUT_OF_RANGE;
+    else
+        *value = result;
+    if(copy != buffer)
+        csplit_free(copy);
+    return err;
+}
+
 
-            current_location = next_location;
+/**
+ * @brief Version of csplit_parse_int64 for input and token of known length, which may contain NUL characters
+ * @ingroup core
+ *
+ * @params[out]: values     -> caller owned array that receives the value of each field, in input order
+ * @params[out]: errors     -> if not NULL, caller owned array that receives the error code of each field
+ * @params[in]: max_values  -> number of elements available in values and errors
+ * @params[out]: num_values -> number of fields in the input, even if larger than max_values
+ * @params[in]: data        -> input which will be split
+ * @params[in]: len         -> number of bytes in data
+ * @params[in]: token       -> bytes on which to split
+ * @params[in]: token_len   -> number of bytes in token
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if values was too small, otherwise the error of the first invalid field
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_int64_n(int64_t* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* data, size_t len, const char* token, size_t token_len){
+    CSplitIter_t iter;
+    CSplitView_t view;
+    CSplitError_t err = CSPLIT_SUCCESS;
+    size_t count = 0;
+    if(values == NULL || num_values == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_PARSE);
+    csplit_iter_setup(&iter, data, len, token, token_len, PTRDIFF_MAX);
+    while(csplit_iter_next(&iter, &view)){
+        if(count < max_values){
+            CSplitError_t field_err = csplit_view_to_int64(view.text, view.len, &values[count]);
+            if(errors != NULL)
+                errors[count] = field_err;
+            if(err == CSPLIT_SUCCESS)
+                err = field_err;
         }
-        num_splits++;
+        count++;
     }
+    *num_values = count;
+    if(count > max_values)
+        return CSPLIT_BUFF_EXCEEDED;
     return err;
 }
 
 
+/**
+ * @brief Function that splits a string and parses every field as a 64 bit integer, without copying the fields.
+ * Fields are parsed as with csplit_view_to_int64, and an invalid field does not stop the others from being parsed.
+ * @ingroup core
+ *
+ * @params[out]: values     -> caller owned array that receives the value of each field, in input order
+ * @params[out]: errors     -> if not NULL, caller owned array that receives the error code of each field
+ * @params[in]: max_values  -> number of elements available in values and errors
+ * @params[out]: num_values -> number of fields in the input, even if larger than max_values
+ * @params[in]: input_str   -> input string which will be split
+ * @params[in]: token       -> string on which to split
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if values was too small, otherwise the error of the first invalid field
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_int64(int64_t* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* input_str, const char* token){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_parse_int64_n(values, errors, max_values, num_values, input_str, strlen(input_str), token, strlen(token));
+}
+
 
 /**
- * @brief Function that allows user to split based on a limited number of splits, either forward
- * or in reverse. A max_splits >= len(input_str) will guarantee all possible splits
+ * @brief Version of csplit_parse_double for input and token of known length, which may contain NUL characters
  * @ingroup core
- * 
- * @params[out]: list           -> output list splitting input str on string token
- * @params[in]: input_str       -> input string which will be split
- * @params[in]: token           -> string on which to split
- * @params[in]: max_splits      -> max number of splits to perform. Negative if starting from end of string.
- * @return:     err             -> error code if there was a problem with csplitting.
+ *
+ * @params[out]: values     -> caller owned array that receives the value of each field, in input order
+ * @params[out]: errors     -> if not NULL, caller owned array that receives the error code of each field
+ * @params[in]: max_values  -> number of elements available in values and errors
+ * @params[out]: num_values -> number of fields in the input, even if larger than max_values
+ * @params[in]: data        -> input which will be split
+ * @params[in]: len         -> number of bytes in data
+ * @params[in]: token       -> bytes on which to split
+ * @params[in]: token_len   -> number of bytes in token
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if values was too small, otherwise the error of the first invalid field
  */
 _CSPLIT_FUNC
-CSplitError_t csplit_lim(CSplitList_t* list, char* input_str, char* token, int max_splits){
+CSplitError_t csplit_parse_double_n(double* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* data, size_t len, const char* token, size_t token_len){
+    CSplitIter_t iter;
+    CSplitView_t view;
     CSplitError_t err = CSPLIT_SUCCESS;
-    // first check to see if input string is valid and token is valid
-    if(strlen(input_str) < 1 || strlen(token) < 1){
-        err = CSPLIT_TOO_SHORT;
+    size_t count = 0;
+    if(values == NULL || num_values == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_PARSE);
+    csplit_iter_setup(&iter, data, len, token, token_len, PTRDIFF_MAX);
+    while(csplit_iter_next(&iter, &view)){
+        if(count < max_values){
+            CSplitError_t field_err = csplit_view_to_double(view.text, view.len, &values[count]);
+            if(errors != NULL)
+                errors[count] = field_err;
+            if(err == CSPLIT_SUCCESS)
+                err = field_err;
+        }
+        count++;
+    }
+    *num_values = count;
+    if(count > max_values)
+        return CSPLIT_BUFF_EXCEEDED;
+    return err;
+}
+
+
+/**
+ * @brief Function that splits a string and parses every field as a double, without copying the fields.
+ * Fields are parsed as with csplit_view_to_double, and an invalid field does not stop the others from being parsed.
+ * @ingroup core
+ *
+ * @params[out]: values     -> caller owned array that receives the value of each field, in input order
+ * @params[out]: errors     -> if not NULL, caller owned array that receives the error code of each field
+ * @params[in]: max_values  -> number of elements available in values and errors
+ * @params[out]: num_values -> number of fields in the input, even if larger than max_values
+ * @params[in]: input_str   -> input string which will be split
+ * @params[in]: token       -> string on which to split
+ * @return: err             -> CSPLIT_BUFF_EXCEEDED if values was too small, otherwise the error of the first invalid field
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_parse_double(double* values, CSplitError_t* errors, size_t max_values, size_t* num_values, const char* input_str, const char* token){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_parse_double_n(values, errors, max_values, num_values, input_str, strlen(input_str), token, strlen(token));
+}
+
+
+/**
+ * @brief Version of csplit_field for input and token of known length, which may contain NUL characters
+ * @ingroup core
+ *
+ * @params[in]: data        -> input to take the field from. The returned view points into it.
+ * @params[in]: len         -> number of bytes in data
+ * @params[in]: token       -> bytes separating the fields
+ * @params[in]: token_len   -> number of bytes in token
+ * @params[in]: index       -> index of the field (can be negative for counting from the end of the input)
+ * @return: field           -> view of the field, with a NULL text if there is no such field
+ */
+_CSPLIT_FUNC
+CSplitView_t csplit_field_n(const char* data, size_t len, const char* token, size_t token_len, ptrdiff_t index){
+    CSplitIter_t iter;
+    CSplitView_t field;
+    size_t target_index;
+    field.text = NULL;
+    field.len = 0;
+    if(data == NULL || token == NULL || len == 0 || token_len == 0)
+        return field;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_VIEW);
+    // negative indexes scan back from the end, so either way only the fields up to the target are found
+    if(index < 0){
+        target_index = (size_t) -(index + 1);
+        csplit_iter_setup(&iter, data, len, token, token_len, -PTRDIFF_MAX);
     }
     else{
-        // otherwise we split on the given string
-        err = csplit_str(list, input_str, token, max_splits);
+        target_index = (size_t) index;
+        csplit_iter_setup(&iter, data, len, token, token_len, PTRDIFF_MAX);
     }
-    return err;
+    while(csplit_iter_next(&iter, &field)){
+        if(target_index == 0)
+            return field;
+        target_index--;
+    }
+    field.text = NULL;
+    field.len = 0;
+    return field;
 }
 
 
 /**
- * @brief Top level csplit function call. Outputs a csplit list split on a string token. Calls
- * csplit_lim with max_splits = len(input_str), ensuring that all possible splits will be made.
+ * @brief Function that finds a single field of a string without splitting the rest of it. The input is only scanned
+ * up to the end of the field, or back to its start for negative indexes, and nothing is copied.
  * @ingroup core
- * 
- * @params[out]: list           -> output list splitting input str on string token
- * @params[in]: input_str       -> input string which will be split
- * @params[in]: token           -> string on which to split 
- * @return:     err             -> error code if there was a problem with csplitting.
+ *
+ * @params[in]: input_str   -> input string to take the field from. The returned view points into it.
+ * @params[in]: token       -> string separating the fields
+ * @params[in]: index       -> index of the field (can be negative for counting from the end of the string)
+ * @return: field           -> view of the field, with a NULL text if there is no such field
  */
 _CSPLIT_FUNC
-CSplitError_t csplit(CSplitList_t* list, char* input_str, char* token){
-    return csplit_lim(list, input_str, token, (int) strlen(input_str));
+CSplitView_t csplit_field(const char* input_str, const char* token, int index){
+    if(input_str == NULL || token == NULL){
+        CSplitView_t field;
+        field.text = NULL;
+        field.len = 0;
+        return field;
+    }
+    return csplit_field_n(input_str, strlen(input_str), token, strlen(token), index);
 }
 
 
 /**
- * @brief Function that runs csplit and then reverses the output.
+ * @brief Version of csplit_fields for input and token of known length, which may contain NUL characters
  * @ingroup core
- * 
- * @params[out]: output_list    -> output list splitting input str on string token
- * @params[in]: input_str       -> input string which will be split
- * @params[in]: token           -> string on which to split 
- * @return:     err             -> error code if there was a problem with csplitting.
+ *
+ * @params[out]: fields     -> caller owned array of num_indexes views, receiving the field at each index
+ * @params[in]: indexes     -> indexes of the fields to take, in ascending order
+ * @params[in]: num_indexes -> number of elements in indexes
+ * @params[in]: data        -> input to take the fields from. The views point into it.
+ * @params[in]: len         -> number of bytes in data
+ * @params[in]: token       -> bytes separating the fields
+ * @params[in]: token_len   -> number of bytes in token
+ * @return: err             -> CSPLIT_NO_SUCH_INDEX if a field was not found, in which case its view has a NULL text
  */
 _CSPLIT_FUNC
-CSplitError_t rcsplit(CSplitList_t* output_list, char* input_str, char* token){
-    CSplitError_t err = csplit(output_list, input_str, token);
-    if(err != CSPLIT_SUCCESS)
-        return err;
-    err = csplit_reverse_list(output_list);
+CSplitError_t csplit_fields_n(CSplitView_t* fields, const size_t* indexes, size_t num_indexes, const char* data, size_t len, const char* token, size_t token_len){
+    CSplitIter_t iter;
+    CSplitView_t view;
+    CSplitError_t err = CSPLIT_SUCCESS;
+    size_t position = 0;
+    size_t i = 0;
+    if(fields == NULL || indexes == NULL || data == NULL || token == NULL || len == 0 || token_len == 0)
+        return CSPLIT_TOO_SHORT;
+    CSPLIT_STAT_CALL(CSPLIT_CALL_VIEW);
+    csplit_iter_setup(&iter, data, len, token, token_len, PTRDIFF_MAX);
+    // the scan stops as soon as the last requested field is found
+    while(i < num_indexes && csplit_iter_next(&iter, &view)){
+        while(i < num_indexes && indexes[i] <= position){
+            if(indexes[i] == position)
+                fields[i] = view;
+            else{
+                // out of order index, which has already been passed
+                fields[i].text = NULL;
+                fields[i].len = 0;
+                err = CSPLIT_NO_SUCH_INDEX;
+            }
+            i++;
+        }
+        position++;
+    }
+    // indexes past the last field of the input
+    for(; i < num_indexes; i++){
+        fields[i].text = NULL;
+        fields[i].len = 0;
+        err = CSPLIT_NO_SUCH_INDEX;
+    }
     return err;
 }
 
+
+/**
+ * @brief Function that takes several fields of a string in a single pass, such as a few columns of a csv line.
+ * The input is only scanned up to the end of the last requested field, and nothing is copied.
+ * @ingroup core
+ *
+ * @params[out]: fields     -> caller owned array of num_indexes views, receiving the field at each index
+ * @params[in]: indexes     -> indexes of the fields to take, in ascending order
+ * @params[in]: num_indexes -> number of elements in indexes
+ * @params[in]: input_str   -> input string to take the fields from. The views point into it.
+ * @params[in]: token       -> string separating the fields
+ * @return: err             -> CSPLIT_NO_SUCH_INDEX if a field was not found, in which case its view has a NULL text
+ */
+_CSPLIT_FUNC
+CSplitError_t csplit_fields(CSplitView_t* fields, const size_t* indexes, size_t num_indexes, const char* input_str, const char* token){
+    if(input_str == NULL || token == NULL)
+        return CSPLIT_TOO_SHORT;
+    return csplit_fields_n(fields, indexes, num_indexes, input_str, strlen(input_str), token, strlen(token));
+}
+
 #ifdef __cplusplus
 }
 #endif
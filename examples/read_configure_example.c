@@ -58,13 +58,10 @@ int main(int argc, char** argv){
         if(csplit_startswith(line_buff, "#") != 0 && strlen(line_buff) > 1){
             CSplitList_t* list = csplit_init_list();
             
-            // initialize list, strip of whitespace, and split on '=' character.
-            char* temp = csplit_strip(line_buff);
+            // initialize list, strip of whitespace in place, and split on '=' character.
+            char* temp = csplit_strip_inplace(line_buff);
             CSplitError_t err = csplit(list, temp, "=");
             
-            // free up the stripped string
-            free(temp);
-            
             // print some info
             printf("Found config line:\n");
             csplit_print_list_info(list, stdout);
@@ -35,6 +35,42 @@
 #include <stdio.h>
 
 
+/**
+ * Function that splits a single line of the file on commas, and prints the sum of its values
+ */
+void process_line(CSplitView_t* line){
+    // ignore lines that are blank
+    if(line->len > 0){
+        // strip whitespace, and parse the values between commas straight into an array.
+        // Stripping to a view copies nothing, and the fields are never copied into strings,
+        // so no memory is allocated.
+        int64_t values[16];
+        CSplitError_t errors[16];
+        size_t num_values = 0;
+        CSplitView_t stripped = csplit_strip_view(line->text, line->len);
+        if(stripped.len > 0)
+            csplit_parse_int64_n(values, errors, 16, &num_values, stripped.text, stripped.len, ",", 1);
+
+        // print the parsed values and sum them, skipping fields that are not numbers
+        long long sum = 0;
+        size_t i;
+        for(i = 0; i < num_values && i < 16; i++){
+            if(errors[i] == CSPLIT_SUCCESS){
+                printf("Value %zu: %lld\n", i, (long long) values[i]);
+                sum = sum + values[i];
+            }
+            else
+                printf("Value %zu is not a number\n", i);
+        }
+
+        // print sum of numbers in line
+        printf("The sum of the elements in the line = %lld\n", sum);
+
+        printf("----------------------\n");
+    }
+}
+
+
 int main(int argc, char** argv){
     // open the file, return if NULL
     FILE* csv_file = fopen("exampleFiles/test.csv", "r");
@@ -43,36 +79,29 @@ int main(int argc, char** argv){
         return -1;
     }
 
-    // buffer for reading from file
-    char buffer[256];
-    while(fgets(buffer, 256, csv_file)) {
-
-        // ignore lines that are blank
-        if(strlen(buffer) > 1){
-            // initialize the list, strip whitespace, and call csplit on commas
-            CSplitList_t* list = csplit_init_list();
-            char* temp = csplit_strip(buffer);
-            CSplitError_t err = csplit(list, temp, ",");
-            free(temp); /* Make sure to free stripped line */
-
-            // print the split values
-            csplit_print_list_info(list, stdout);
-
-            // example iterating through resulting list and summing values read from .csv file
-            CSplitFragment_t* current_fragment = list->head;
-            int sum = 0;
-            while(current_fragment != NULL){
-                sum = sum + atoi(current_fragment->text);
-                current_fragment = current_fragment->next;
-            }
+    // split the file into lines as it is read. Lines may be longer than the buffer,
+    // the stream keeps the unfinished line between reads.
+    CSplitStream_t* stream = csplit_init_stream("\n", 1);
+    if(stream == NULL){
+        printf("Failed to create stream, exiting.\n");
+        fclose(csv_file);
+        return -1;
+    }
+    CSplitView_t line;
+    char buffer[16];
+    size_t num_read;
+    while((num_read = fread(buffer, 1, sizeof(buffer), csv_file)) > 0) {
+        csplit_stream_feed(stream, buffer, num_read);
+        while(csplit_stream_next(stream, &line) > 0)
+            process_line(&line);
+    }
 
-            // print sum of numbers in line, and free memory
-            printf("The sum of the elements in the line = %d\n", sum);
-            csplit_clear_list(list);
+    // the last line may not end with a newline
+    csplit_stream_finish(stream);
+    while(csplit_stream_next(stream, &line) > 0)
+        process_line(&line);
 
-            printf("----------------------\n");
-        }
-    }
+    csplit_clear_stream(stream);
     fclose(csv_file);
     return 0;
 }
\ No newline at end of file
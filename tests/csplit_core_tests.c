@@ -29,6 +29,8 @@
  */
 
 
+#define CSPLIT_THREADS
+#define CSPLIT_STATS
 #include "csplit.h"
 
 #include "criterion/assert.h"
@@ -37,6 +39,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 
 // --------------------------------------------------------
 // ------ Some values and variables used by tests ---------
@@ -154,6 +157,32 @@ Test(asserts, csplit_strip_failed_test, .init=setup_strings, .fini=teardown){
 }
 
 
+/* Test for csplit_strip_view and csplit_strip_inplace functions */
+Test(asserts, csplit_strip_view_test, .init=setup_strings, .fini=teardown){
+    CSplitView_t stripped = csplit_strip_view(input_test_string_w_whitespace, strlen(input_test_string_w_whitespace));
+    cr_assert(stripped.len == strlen(input_test_string) && memcmp(stripped.text, input_test_string, stripped.len) == 0, "Stripped view doesn't match expected.");
+    stripped = csplit_strip_view(" \t\n", 3);
+    cr_assert(stripped.len == 0, "All whitespace input not empty");
+    char buffer[64];
+    strcpy(buffer, input_test_string_w_whitespace);
+    char* output_str = csplit_strip_inplace(buffer);
+    cr_assert(strcmp(output_str, input_test_string) == 0, "Output string doesn't match expected.");
+    list = NULL;
+}
+
+
+/* Test for csplit_strip_into function */
+Test(asserts, csplit_strip_into_test, .init=setup_strings, .fini=teardown){
+    char buffer[32];
+    size_t out_len = 0;
+    CSplitError_t err = csplit_strip_into(buffer, sizeof(buffer), "  a b  ", 7, &out_len);
+    cr_assert(err == CSPLIT_SUCCESS && out_len == 3 && strcmp(buffer, "a b") == 0, "Output string doesn't match expected.");
+    err = csplit_strip_into(buffer, 3, "  a b  ", 7, &out_len);
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED, "Buffer without room for terminator not rejected");
+    list = NULL;
+}
+
+
 // --------------------------------------------------------
 // -------- Tests for 'remove whitespace' function --------
 // --------------------------------------------------------
@@ -175,6 +204,43 @@ Test(asserts, csplit_remove_whitespace_failed_test, .init=setup_strings, .fini=t
 }
 
 
+/* Test for csplit_remove_whitespace_inplace and csplit_remove_whitespace_into functions */
+Test(asserts, csplit_remove_whitespace_inplace_test, .init=setup_strings, .fini=teardown){
+    char buffer[32];
+    size_t out_len = 0;
+    CSplitError_t err = csplit_remove_whitespace_into(buffer, sizeof(buffer), " a\tb\nc ", 7, &out_len);
+    cr_assert(err == CSPLIT_SUCCESS && out_len == 3 && strcmp(buffer, "abc") == 0, "Output string doesn't match expected.");
+    err = csplit_remove_whitespace_into(buffer, 3, " a\tb\nc ", 7, &out_len);
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED, "Buffer without room for terminator not rejected");
+    strcpy(buffer, input_test_string_w_whitespace);
+    size_t len = csplit_remove_whitespace_inplace(buffer);
+    cr_assert(len == 20 && strcmp(buffer, "Hellohowareyoudoing?") == 0, "In place output doesn't match expected.");
+    list = NULL;
+}
+
+
+/* Test for csplit_remove_whitespace on input spanning many SIMD blocks */
+Test(asserts, csplit_remove_whitespace_long_test, .init=setup_strings, .fini=teardown){
+    char input[301];
+    char expected[301];
+    size_t expected_len = 0;
+    int i;
+    for(i = 0; i < 300; i++){
+        // long runs with and without whitespace, so whole blocks are both copied and compacted
+        input[i] = (i % 7 == 0 || (i > 100 && i < 140)) ? " \t\n\v\f\r"[i % 6] : 'a' + i % 26;
+        if(!isspace((unsigned char) input[i]))
+            expected[expected_len++] = input[i];
+    }
+    input[300] = '\0';
+    expected[expected_len] = '\0';
+    char* output_str = csplit_remove_whitespace(input);
+    cr_assert(strcmp(output_str, expected) == 0, "Output string doesn't match expected.");
+    free(output_str);
+    cr_assert(csplit_remove_whitespace_inplace(input) == expected_len && strcmp(input, expected) == 0, "In place output doesn't match expected.");
+    list = NULL;
+}
+
+
 // --------------------------------------------------------
 // -------- Tests for 'starts/ends with' functions --------
 // --------------------------------------------------------
@@ -306,3 +372,956 @@ Test(asserts, csplit_rstring_lim_test, .init=setup_strings, .fini=teardown){
     cr_assert(strcmp(list->head->text, "HelloCoolW") == 0, "First string not as expected");
     cr_assert(strcmp(list->tail->text, "rld!") == 0, "Second string not as expected");
 }
+
+
+// --------------------------------------------------------
+// ------------- Tests for zero-copy view splits ----------
+// --------------------------------------------------------
+
+/* Test for splitting into views on every token */
+Test(asserts, csplit_view_max_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitView_t views[8];
+    size_t num_views;
+    char* short_test_str = "Hello Cool World!";
+    CSplitError_t err = csplit_view(views, 8, &num_views, short_test_str, " ");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(num_views == 3, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].text == short_test_str && views[0].len == 5, "First view not as expected");
+    cr_assert(strncmp(views[1].text, "Cool", views[1].len) == 0 && views[1].len == 4, "Second view not as expected");
+    cr_assert(strncmp(views[2].text, "World!", views[2].len) == 0 && views[2].len == 6, "Third view not as expected");
+}
+
+/* Test for limited forward and reverse view splits on string token */
+Test(asserts, csplit_view_lim_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitView_t views[8];
+    size_t num_views;
+    char* short_test_str = "HelloCoolWoorld!";
+    CSplitError_t err = csplit_view_lim(views, 8, &num_views, short_test_str, "oo", 1);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 2, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == 6 && strncmp(views[0].text, "HelloC", 6) == 0, "First view not as expected");
+    cr_assert(views[1].len == 8 && strncmp(views[1].text, "lWoorld!", 8) == 0, "Second view not as expected");
+    err = csplit_view_lim(views, 8, &num_views, short_test_str, "oo", -1);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 2, "Number of reverse fragments parsed is not as expected");
+    cr_assert(views[0].len == 10 && strncmp(views[0].text, "HelloCoolW", 10) == 0, "First reverse view not as expected");
+    cr_assert(views[1].len == 4 && strncmp(views[1].text, "rld!", 4) == 0, "Second reverse view not as expected");
+}
+
+/* Test for reverse view split and empty fragments */
+Test(asserts, rcsplit_view_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitView_t views[8];
+    size_t num_views;
+    CSplitError_t err = rcsplit_view(views, 8, &num_views, "a,,b,", ",");
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 4, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == 0, "First view not as expected");
+    cr_assert(views[1].len == 1 && views[1].text[0] == 'b', "Second view not as expected");
+    cr_assert(views[2].len == 0, "Third view not as expected");
+    cr_assert(views[3].len == 1 && views[3].text[0] == 'a', "Fourth view not as expected");
+}
+
+/* Test for view split with too small output array */
+Test(asserts, csplit_view_exceeded_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitView_t views[2];
+    size_t num_views;
+    CSplitError_t err = csplit_view(views, 2, &num_views, "1,2,3,4", ",");
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED, "Unexpected error code");
+    cr_assert(num_views == 4, "Required number of views not reported");
+    err = csplit_view(views, 2, &num_views, "", ",");
+    cr_assert(err == CSPLIT_TOO_SHORT, "Unexpected error code");
+}
+
+
+// --------------------------------------------------------
+// ------------- Tests for arena backed lists -------------
+// --------------------------------------------------------
+
+/* Test for splitting into an arena backed list */
+Test(asserts, csplit_arena_list_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_arena_list(0);
+    char* short_test_str = "Hello Cool World!";
+    CSplitError_t err = csplit(list, short_test_str, " ");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(list->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(strcmp(list->head->text, "Hello") == 0, "First string not as expected");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 1), "Cool") == 0, "Second string not as expected");
+    cr_assert(strcmp(list->tail->text, "World!") == 0, "Third string not as expected");
+    err = csplit_reverse_list(list);
+    cr_assert(strcmp(list->head->text, "World!") == 0, "List not reversed correctly.");
+}
+
+/* Test for arena backed list that must grow past its first block */
+Test(asserts, csplit_arena_growth_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_arena_list(64);
+    char input[2048];
+    int i;
+    for(i = 0; i < 2047; i++)
+        input[i] = (i % 4 == 3) ? ',' : 'a' + (i % 4);
+    input[2047] = '\0';
+    CSplitError_t err = csplit(list, input, ",");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(list->num_elems == 512, "Number of fragments parsed is not as expected");
+    cr_assert(list->arena->next != NULL, "Arena did not grow");
+    CSplitFragment_t* current_fragment = list->head;
+    while(current_fragment != NULL){
+        cr_assert(strcmp(current_fragment->text, "abc") == 0, "Fragment not as expected");
+        current_fragment = current_fragment->next;
+    }
+}
+
+/* Test for resetting a list and splitting into it again without new fragments */
+Test(asserts, csplit_reset_list_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_list();
+    char* short_test_str = "Hello Cool World!";
+    CSplitError_t err = csplit(list, short_test_str, " ");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    CSplitFragment_t* first = list->head;
+    CSplitFragment_t* last = list->tail;
+    csplit_reset_list(list, 0);
+    cr_assert(list->num_elems == 0 && list->head == NULL && list->tail == NULL, "List not emptied");
+    err = csplit(list, "a,bb,Longer than before", ",");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(list->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(list->head == first && list->tail == last, "Fragments not reused");
+    cr_assert(list->spare == NULL, "Unexpected spare fragments");
+    cr_assert(strcmp(list->head->text, "a") == 0, "First string not as expected");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 1), "bb") == 0, "Second string not as expected");
+    cr_assert(strcmp(list->tail->text, "Longer than before") == 0, "Third string not as expected");
+    csplit_reset_list(list, 0);
+    err = csplit(list, "one", ",");
+    cr_assert(list->num_elems == 1 && list->spare != NULL, "Unused fragments not kept");
+    csplit_reset_list(list, 1);
+    cr_assert(list->num_elems == 0 && list->spare == NULL, "List not shrunk");
+    err = csplit(list, "x y", " ");
+    cr_assert(strcmp(list->tail->text, "y") == 0, "String not as expected after shrink");
+}
+
+/* Test for resetting an arena backed list */
+Test(asserts, csplit_reset_arena_list_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_arena_list(64);
+    char input[2048];
+    int i;
+    for(i = 0; i < 2047; i++)
+        input[i] = (i % 4 == 3) ? ',' : 'a' + (i % 4);
+    input[2047] = '\0';
+    CSplitError_t err = csplit(list, input, ",");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    csplit_reset_list(list, 0);
+    cr_assert(list->num_elems == 0 && list->arena->next->next == NULL, "Arena blocks not merged");
+    CSplitArenaBlock_t* merged = list->arena;
+    err = csplit(list, input, ",");
+    cr_assert(list->num_elems == 512 && list->arena == merged, "Arena grew after reset");
+    cr_assert(strcmp(list->tail->text, "abc") == 0, "Fragment not as expected");
+    csplit_reset_list(list, 0);
+    cr_assert(list->arena == merged, "Merged block not kept");
+    csplit_reset_list(list, 1);
+    cr_assert(list->arena->next == NULL, "Arena not shrunk");
+    err = csplit(list, "Hello Cool World!", " ");
+    cr_assert(strcmp(list->head->text, "Hello") == 0, "First string not as expected after shrink");
+}
+
+
+/* Allocator for the list allocator test, counting outstanding allocations and bytes */
+typedef struct TEST_POOL {
+    size_t allocs;
+    size_t bytes;
+} TestPool_t;
+
+void* test_pool_alloc(void* user_data, size_t size){
+    TestPool_t* pool = (TestPool_t*) user_data;
+    pool->allocs++;
+    pool->bytes = pool->bytes + size;
+    return malloc(size);
+}
+
+void test_pool_free(void* user_data, void* ptr, size_t size){
+    TestPool_t* pool = (TestPool_t*) user_data;
+    pool->allocs--;
+    pool->bytes = pool->bytes - size;
+    free(ptr);
+}
+
+/* Test for a list using its own allocator, which must be given back every size it handed out */
+Test(asserts, csplit_allocator_list_test, .init=setup_strings, .fini=teardown){
+    TestPool_t pool = {0, 0};
+    CSplitAllocator_t allocator = {test_pool_alloc, test_pool_free, &pool};
+    CSplitAllocator_t incomplete = {test_pool_alloc, NULL, &pool};
+    cr_assert(csplit_init_allocator_list(&incomplete) == NULL, "List created with incomplete allocator");
+    list = csplit_init_allocator_list(&allocator);
+    CSplitError_t err = csplit(list, "Hello Cool World!", " ");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(pool.allocs == 7, "Fragments not allocated with the allocator");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 1), "Cool") == 0, "Second string not as expected");
+    csplit_reset_list(list, 0);
+    err = csplit(list, "A much longer first fragment,b", ",");
+    cr_assert(err == CSPLIT_SUCCESS && pool.allocs == 7, "Reused fragments not allocated with the allocator");
+    cr_assert(strcmp(list->head->text, "A much longer first fragment") == 0, "First string not as expected");
+    csplit_reset_list(list, 1);
+    cr_assert(pool.allocs == 1, "Fragments not freed with the allocator");
+    csplit_clear_list(list);
+    cr_assert(pool.allocs == 0 && pool.bytes == 0, "Sizes given to free do not match the allocations");
+    list = NULL;
+}
+
+// --------------------------------------------------------
+// ------------- Tests for array backed results -----------
+// --------------------------------------------------------
+
+/* Test for splitting into an array and getting views at indexes */
+Test(asserts, csplit_array_index_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitArray_t* array = csplit_init_array();
+    CSplitError_t err = csplit_array(array, input_test_string, " ");
+    cr_assert(err == CSPLIT_SUCCESS && array->num_elems == 5, "Number of fragments parsed is not as expected");
+    const CSplitView_t* view = csplit_get_view_at_index(array, 3);
+    cr_assert(view->len == 3 && strncmp(view->text, "you", 3) == 0, "View at index not correct.");
+    view = csplit_get_view_at_index(array, -1);
+    cr_assert(view->len == 6 && strncmp(view->text, "doing?", 6) == 0, "View at reverse index not correct.");
+    cr_assert(csplit_get_view_at_index(array, 5) == NULL, "View at index not correct.");
+    cr_assert(csplit_get_view_at_index(array, -6) == NULL, "View at index not correct.");
+    csplit_clear_array(array);
+}
+
+/* Test for reversing an array, and appending to a reversed array */
+Test(asserts, csplit_array_reverse_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitArray_t* array = csplit_init_array();
+    CSplitError_t err = rcsplit_array(array, "a,b,c", ",");
+    cr_assert(err == CSPLIT_SUCCESS && array->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(csplit_get_view_at_index(array, 0)->text[0] == 'c', "Array not reversed correctly.");
+    cr_assert(csplit_get_view_at_index(array, -1)->text[0] == 'a', "Array not reversed correctly.");
+    err = csplit_array(array, "d", ",");
+    cr_assert(array->num_elems == 4 && csplit_get_view_at_index(array, 3)->text[0] == 'd', "View not appended correctly.");
+    cr_assert(csplit_get_view_at_index(array, 2)->text[0] == 'a', "Existing views not kept in order.");
+    csplit_clear_array(array);
+}
+
+/* Test for reverse limited split into an array */
+Test(asserts, csplit_array_rlim_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    CSplitArray_t* array = csplit_init_array();
+    CSplitError_t err = csplit_array_lim(array, "HelloCoolWoorld!", "oo", -1);
+    cr_assert(err == CSPLIT_SUCCESS && array->num_elems == 2, "Number of fragments parsed is not as expected");
+    cr_assert(array->elems[0].len == 10 && strncmp(array->elems[0].text, "HelloCoolW", 10) == 0, "First view not as expected");
+    cr_assert(array->elems[1].len == 4 && strncmp(array->elems[1].text, "rld!", 4) == 0, "Second view not as expected");
+    csplit_clear_array(array);
+}
+
+
+// --------------------------------------------------------
+// ---------- Tests for single byte token scanning --------
+// --------------------------------------------------------
+
+/* Test for single byte split on input spanning many scanning blocks */
+Test(asserts, csplit_long_char_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    char input[200];
+    CSplitView_t views[200];
+    size_t num_views, i, start = 0, count = 0;
+    // delimiters at irregular positions, including adjacent ones and block boundaries
+    for(i = 0; i < 199; i++)
+        input[i] = (i % 7 == 0 || i % 16 == 15 || i % 32 == 0) ? ',' : 'x';
+    input[199] = '\0';
+    CSplitError_t err = csplit_view(views, 200, &num_views, input, ",");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    for(i = 0; i <= 199; i++){
+        if(i == 199 || input[i] == ','){
+            cr_assert(views[count].text == input + start && views[count].len == i - start, "View not as expected");
+            count++;
+            start = i + 1;
+        }
+    }
+    cr_assert(num_views == count, "Number of fragments parsed is not as expected");
+    err = csplit_view_lim(views, 200, &num_views, input, ",", 3);
+    cr_assert(num_views == 4 && views[3].text == input + 15 && views[3].len == 184, "Limited split not as expected");
+}
+
+
+// --------------------------------------------------------
+// ------------- Tests for compiled tokens ----------------
+// --------------------------------------------------------
+
+/* Test for splitting on a compiled multi character token */
+Test(asserts, csplit_compiled_test, .init=setup_strings, .fini=teardown){
+    CSplitToken_t token;
+    CSplitError_t err = csplit_compile_token(&token, "oo");
+    cr_assert(err == CSPLIT_SUCCESS && token.len == 2, "Token not compiled as expected");
+    list = csplit_init_list();
+    err = csplit_compiled(list, "HelloCoolWoorld!", &token, 16);
+    cr_assert(list->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(strcmp(list->head->text, "HelloC") == 0, "First string not as expected");
+    cr_assert(strcmp(list->head->next->text, "lW") == 0, "Second string not as expected");
+    cr_assert(strcmp(list->tail->text, "rld!") == 0, "Third string not as expected");
+    csplit_clear_list(list);
+    list = csplit_init_list();
+    err = csplit_compiled(list, "HelloCoolWoorld!", &token, -1);
+    cr_assert(list->num_elems == 2, "Number of fragments parsed is not as expected");
+    cr_assert(strcmp(list->head->text, "HelloCoolW") == 0, "First string not as expected");
+    cr_assert(strcmp(list->tail->text, "rld!") == 0, "Second string not as expected");
+    err = csplit_compile_token(&token, "");
+    cr_assert(err == CSPLIT_TOO_SHORT, "Unexpected error code");
+}
+
+/* Test for splitting on a long periodic token, which uses the two-way search */
+Test(asserts, csplit_compiled_two_way_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    char token_str[41], input[200];
+    CSplitView_t views[8];
+    size_t num_views;
+    CSplitToken_t token;
+    memset(token_str, 'a', 40);
+    token_str[39] = 'b';
+    token_str[40] = '\0';
+    // runs of 'a' that almost match the token, then two real matches
+    memset(input, 'a', 199);
+    input[120] = 'b';
+    input[160] = 'b';
+    input[199] = '\0';
+    csplit_compile_token(&token, token_str);
+    cr_assert(token.two_way, "Long token not compiled for two-way search");
+    CSplitError_t err = csplit_view_compiled(views, 8, &num_views, input, &token, 199);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 3, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == 81 && views[1].len == 0 && views[2].len == 38, "Views not as expected");
+}
+
+/* Test for reverse splits on a long periodic token, which use the reverse two-way search */
+Test(asserts, csplit_compiled_two_way_reverse_test, .init=setup_strings, .fini=teardown){
+    list = NULL;
+    size_t len = 1 << 22;
+    char token_str[4001];
+    CSplitView_t views[4];
+    size_t num_views;
+    CSplitToken_t token;
+    memset(token_str, 'a', 4000);
+    token_str[2000] = 'b';
+    token_str[4000] = '\0';
+    // the input almost matches at every position, which is quadratic for a search without the reverse tables
+    char* input = (char*) malloc(len + 1);
+    memset(input, 'a', len);
+    input[len] = '\0';
+    csplit_compile_token(&token, token_str);
+    CSplitError_t err = csplit_view_compiled(views, 4, &num_views, input, &token, -1);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 1 && views[0].len == len, "Token found in input without it");
+    // place two matches, and take the last one only
+    input[10002] = 'b';
+    input[len - 2000 - 7] = 'b';
+    err = csplit_view_compiled(views, 4, &num_views, input, &token, -1);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 2, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == len - 4000 - 7 && views[1].len == 7, "Views not as expected");
+    err = csplit_view_compiled(views, 4, &num_views, input, &token, -2);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 3 && views[0].len == 8002, "First match not found");
+    free(input);
+}
+
+/* Test for reverse split of a long input, which scans only as far back as needed */
+Test(asserts, csplit_rstr_long_test, .init=setup_strings, .fini=teardown){
+    size_t len = 1 << 20;
+    char* input = (char*) malloc(len + 1);
+    memset(input, 'x', len);
+    input[len] = '\0';
+    input[10] = ',';
+    input[len - 4] = ',';
+    input[len - 2] = ',';
+    list = csplit_init_list();
+    CSplitError_t err = csplit_lim(list, input, ",", -2);
+    cr_assert(err == CSPLIT_SUCCESS && list->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(strlen(list->head->text) == len - 4, "First string not as expected");
+    cr_assert(strcmp(list->head->next->text, "x") == 0, "Second string not as expected");
+    cr_assert(strcmp(list->tail->text, "x") == 0, "Third string not as expected");
+    free(input);
+}
+
+
+/* Tests for length delimited functions */
+
+Test(asserts, csplit_lim_n_test, .init=setup_strings, .fini=teardown){
+    const char data[] = "a\0b,c\0,,d";
+    list = csplit_init_list();
+    CSplitError_t err = csplit_lim_n(list, data, sizeof(data) - 1, ",", 1, 2);
+    cr_assert(err == CSPLIT_SUCCESS && list->num_elems == 3, "Number of fragments parsed is not as expected");
+    cr_assert(memcmp(list->head->text, "a\0b", 4) == 0, "First string not as expected");
+    cr_assert(memcmp(list->head->next->text, "c\0", 3) == 0, "Second string not as expected");
+    cr_assert(strcmp(list->tail->text, ",d") == 0, "Third string not as expected");
+}
+
+Test(asserts, csplit_n_nul_token_test, .init=setup_strings, .fini=teardown){
+    const char data[] = "ab\0cd\0\0ef";
+    CSplitView_t views[4];
+    size_t num_views;
+    CSplitError_t err = csplit_view_lim_n(views, 4, &num_views, data, sizeof(data) - 1, "\0", 1, -2);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 3, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == 5 && memcmp(views[0].text, "ab\0cd", 5) == 0, "First view not as expected");
+    cr_assert(views[1].len == 0 && views[2].len == 2, "Views not as expected");
+    list = csplit_init_list();
+    err = csplit_n(list, data, 0, "\0", 1);
+    cr_assert(err == CSPLIT_TOO_SHORT && list->num_elems == 0, "Empty input not rejected");
+}
+
+Test(asserts, csplit_strip_n_test, .init=setup_strings, .fini=teardown){
+    size_t out_len = 0;
+    char* stripped = csplit_strip_n("  a\0b \n", 7, &out_len);
+    cr_assert(out_len == 3 && memcmp(stripped, "a\0b", 4) == 0, "Stripped string not as expected");
+    free(stripped);
+    cr_assert(csplit_strip_n(" \t ", 3, NULL) == NULL, "All whitespace input not rejected");
+    list = NULL;
+}
+
+Test(asserts, csplit_startswith_endswith_n_test, .init=setup_strings, .fini=teardown){
+    const char data[] = "ab\0cd";
+    cr_assert(csplit_startswith_n(data, 5, "ab\0c", 4) == 0, "Prefix not matched");
+    cr_assert(csplit_startswith_n(data, 5, "ab\0d", 4) == -1, "Wrong prefix matched");
+    cr_assert(csplit_endswith_n(data, 5, "\0cd", 3) == 0, "Suffix not matched");
+    cr_assert(csplit_endswith_n(data, 2, "\0cd", 3) == -1, "Suffix longer than input matched");
+    list = NULL;
+}
+
+
+/* Tests for streaming splitter */
+
+Test(asserts, csplit_stream_test, .init=setup_strings, .fini=teardown){
+    const char* chunks[] = {"Hello, W", "orld, a", "b, ", "cd,, x"};
+    const char* expected[] = {"Hello", " World", " ab", " cd", "", " x"};
+    CSplitStream_t* stream = csplit_init_stream(",", 1);
+    CSplitView_t fragment;
+    size_t count = 0;
+    for(int i = 0; i < 4; i++){
+        cr_assert(csplit_stream_feed(stream, chunks[i], strlen(chunks[i])) == CSPLIT_SUCCESS, "Chunk not accepted");
+        while(csplit_stream_next(stream, &fragment) > 0){
+            cr_assert(fragment.len == strlen(expected[count]) && memcmp(fragment.text, expected[count], fragment.len) == 0, "Fragment not as expected");
+            count++;
+        }
+    }
+    cr_assert(count == 5, "Number of fragments before end of stream not as expected");
+    csplit_stream_finish(stream);
+    cr_assert(csplit_stream_next(stream, &fragment) == 1 && fragment.len == 2 && memcmp(fragment.text, " x", 2) == 0, "Last fragment not as expected");
+    cr_assert(csplit_stream_next(stream, &fragment) == 0, "Fragment returned after end of stream");
+    csplit_clear_stream(stream);
+    list = NULL;
+}
+
+Test(asserts, csplit_stream_split_token_test, .init=setup_strings, .fini=teardown){
+    // token split across three chunks
+    const char* chunks[] = {"ab<", "-", "->cd<-->"};
+    CSplitStream_t* stream = csplit_init_stream("<-->", 4);
+    CSplitView_t fragment;
+    cr_assert(csplit_stream_feed(stream, chunks[0], 3) == CSPLIT_SUCCESS, "Chunk not accepted");
+    cr_assert(csplit_stream_next(stream, &fragment) == 0, "Fragment returned before token was complete");
+    cr_assert(csplit_stream_feed(stream, chunks[1], 1) == CSPLIT_SUCCESS, "Chunk not accepted");
+    cr_assert(csplit_stream_next(stream, &fragment) == 0, "Fragment returned before token was complete");
+    cr_assert(csplit_stream_feed(stream, chunks[2], 8) == CSPLIT_SUCCESS, "Chunk not accepted");
+    cr_assert(csplit_stream_next(stream, &fragment) == 1 && fragment.len == 2 && memcmp(fragment.text, "ab", 2) == 0, "First fragment not as expected");
+    cr_assert(csplit_stream_next(stream, &fragment) == 1 && fragment.len == 2 && memcmp(fragment.text, "cd", 2) == 0, "Second fragment not as expected");
+    cr_assert(csplit_stream_feed(stream, "x", 1) == CSPLIT_BUFF_EXCEEDED, "Chunk accepted before previous one was consumed");
+    cr_assert(csplit_stream_next(stream, &fragment) == 0, "Fragment returned before end of stream");
+    csplit_stream_finish(stream);
+    cr_assert(csplit_stream_next(stream, &fragment) == 1 && fragment.len == 0, "Last fragment not empty");
+    csplit_clear_stream(stream);
+    list = NULL;
+}
+
+
+/* Tests for file splitting */
+
+Test(asserts, csplit_file_test, .init=setup_strings, .fini=teardown){
+    FILE* fp = fopen("csplit_file_test.txt", "wb");
+    fputs("a,b,c\n\nd,e\n", fp);
+    fclose(fp);
+    CSplitFile_t* file = csplit_open_file("csplit_file_test.txt", NULL);
+    cr_assert(file != NULL, "File not opened");
+    CSplitView_t fields[2];
+    size_t num_fields;
+    int found = csplit_file_next(file, fields, 2, &num_fields, ",", 5);
+    cr_assert(found == CSPLIT_BUFF_EXCEEDED && num_fields == 3, "Too small field array not rejected");
+    found = csplit_file_next(file, fields, 2, &num_fields, ",", 1);
+    cr_assert(found == 1 && num_fields == 2, "Number of fields not as expected");
+    cr_assert(fields[0].len == 1 && fields[1].len == 3 && memcmp(fields[1].text, "b,c", 3) == 0, "Fields not as expected");
+    found = csplit_file_next(file, fields, 2, &num_fields, ",", 1);
+    cr_assert(found == 1 && num_fields == 0, "Empty record not as expected");
+    found = csplit_file_next(file, fields, 2, &num_fields, ",", -1);
+    cr_assert(found == 1 && num_fields == 2 && fields[1].len == 1 && fields[1].text[0] == 'e', "Last record not as expected");
+    cr_assert(csplit_file_next(file, fields, 2, &num_fields, ",", 1) == 0, "Record returned after end of file");
+    csplit_close_file(file);
+    remove("csplit_file_test.txt");
+    list = NULL;
+}
+
+
+/* Tests for parallel splitting */
+
+Test(asserts, csplit_parallel_test, .init=setup_strings, .fini=teardown){
+    // runs of 'a' split on "aa" give different tokens depending on where a scan starts
+    size_t len = 3 * CSPLIT_PARALLEL_MIN_CHUNK + 7;
+    char* input = (char*) malloc(len);
+    size_t i;
+    for(i = 0; i < len; i++)
+        input[i] = (i % 1000 == 999) ? 'b' : 'a';
+    CSplitArray_t* expected = csplit_init_array();
+    CSplitArray_t* array = csplit_init_array();
+    csplit_array_lim_n(expected, input, len, "aa", 2, PTRDIFF_MAX);
+    CSplitError_t err = csplit_array_parallel(array, input, len, "aa", 2, 3);
+    cr_assert(err == CSPLIT_SUCCESS && array->num_elems == expected->num_elems, "Number of fragments parsed is not as expected");
+    for(i = 0; i < array->num_elems; i++)
+        cr_assert(array->elems[i].text == expected->elems[i].text && array->elems[i].len == expected->elems[i].len, "View not as expected");
+    list = csplit_init_list();
+    err = csplit_parallel(list, input, len, "aa", 2, 3);
+    cr_assert(err == CSPLIT_SUCCESS && (size_t) list->num_elems == expected->num_elems, "Number of fragments in list is not as expected");
+    CSplitFragment_t* fragment = list->head;
+    for(i = 0; i < expected->num_elems; i++, fragment = fragment->next)
+        cr_assert(strlen(fragment->text) == expected->elems[i].len, "Fragment not as expected");
+    cr_assert(strcmp(list->tail->text, "a") == 0, "Last fragment not as expected");
+    csplit_clear_array(expected);
+    csplit_clear_array(array);
+    free(input);
+}
+
+int compare_pointers(const void* a, const void* b){
+    uintptr_t x = (uintptr_t) *(void* const*) a;
+    uintptr_t y = (uintptr_t) *(void* const*) b;
+    return (x > y) - (x < y);
+}
+
+/* Test for a parallel split into a reset list, which must reuse the fragments of the previous split */
+Test(asserts, csplit_parallel_reset_test, .init=setup_strings, .fini=teardown){
+    size_t len = 3 * CSPLIT_PARALLEL_MIN_CHUNK;
+    char* input = (char*) malloc(len);
+    size_t i;
+    for(i = 0; i < len; i++)
+        input[i] = (i % 100 == 99) ? ',' : 'a';
+    size_t num_fragments = len / 100 + 1;
+    list = csplit_init_list();
+    CSplitError_t err = csplit_parallel(list, input, len, ",", 1, 3);
+    cr_assert(err == CSPLIT_SUCCESS && (size_t) list->num_elems == num_fragments, "Number of fragments parsed is not as expected");
+    void** first = (void**) malloc(num_fragments * sizeof(void*));
+    CSplitFragment_t* fragment = list->head;
+    for(i = 0; i < num_fragments; i++, fragment = fragment->next)
+        first[i] = fragment;
+    qsort(first, num_fragments, sizeof(void*), compare_pointers);
+    csplit_reset_list(list, 0);
+    err = csplit_parallel(list, input, len, ",", 1, 3);
+    cr_assert(err == CSPLIT_SUCCESS && (size_t) list->num_elems == num_fragments, "Number of fragments parsed is not as expected");
+    cr_assert(list->spare == NULL, "Spare fragments not used");
+    for(fragment = list->head; fragment != NULL; fragment = fragment->next){
+        void* key = fragment;
+        cr_assert(bsearch(&key, first, num_fragments, sizeof(void*), compare_pointers) != NULL, "Fragment allocated again");
+    }
+    cr_assert(strlen(list->head->text) == 99 && strlen(list->tail->text) == len % 100, "Fragments not as expected");
+    free(first);
+    free(input);
+}
+
+/* Allocator that counts the allocations made from a thread other than the one that created the list */
+typedef struct TEST_THREAD_POOL {
+    pthread_t owner;
+    size_t allocs;
+    size_t foreign_calls;
+} TestThreadPool_t;
+
+void* test_thread_pool_alloc(void* user_data, size_t size){
+    TestThreadPool_t* pool = (TestThreadPool_t*) user_data;
+    if(!pthread_equal(pthread_self(), pool->owner))
+        __atomic_add_fetch(&pool->foreign_calls, 1, __ATOMIC_RELAXED);
+    pool->allocs++;
+    return malloc(size);
+}
+
+void test_thread_pool_free(void* user_data, void* ptr, size_t size){
+    TestThreadPool_t* pool = (TestThreadPool_t*) user_data;
+    if(!pthread_equal(pthread_self(), pool->owner))
+        __atomic_add_fetch(&pool->foreign_calls, 1, __ATOMIC_RELAXED);
+    pool->allocs--;
+    free(ptr);
+}
+
+Test(asserts, csplit_parallel_allocator_test, .init=setup_strings, .fini=teardown){
+    size_t len = 3 * CSPLIT_PARALLEL_MIN_CHUNK;
+    char* input = (char*) malloc(len);
+    size_t i;
+    for(i = 0; i < len; i++)
+        input[i] = (i % 100 == 99) ? ',' : 'a';
+    TestThreadPool_t pool;
+    pool.owner = pthread_self();
+    pool.allocs = 0;
+    pool.foreign_calls = 0;
+    CSplitAllocator_t allocator = {test_thread_pool_alloc, test_thread_pool_free, &pool};
+    list = csplit_init_allocator_list(&allocator);
+    CSplitError_t err = csplit_parallel(list, input, len, ",", 1, 3);
+    cr_assert(err == CSPLIT_SUCCESS && (size_t) list->num_elems == len / 100 + 1, "Number of fragments parsed is not as expected");
+    cr_assert(pool.foreign_calls == 0, "Allocator called from a worker thread");
+    csplit_clear_list(list);
+    cr_assert(pool.allocs == 0, "Fragments not freed with the allocator");
+    list = NULL;
+    free(input);
+}
+
+
+/* Tests for iterator and callback splitting */
+
+Test(asserts, csplit_iter_test, .init=setup_strings, .fini=teardown){
+    CSplitIter_t iter;
+    CSplitView_t fragment;
+    CSplitError_t err = csplit_iter_init(&iter, input_test_string, " ", -2);
+    cr_assert(err == CSPLIT_SUCCESS, "Iterator not initialized");
+    cr_assert(csplit_iter_next(&iter, &fragment) == 1 && fragment.len == 6 && memcmp(fragment.text, "doing?", 6) == 0, "First fragment not as expected");
+    cr_assert(csplit_iter_next(&iter, &fragment) == 1 && fragment.len == 3 && memcmp(fragment.text, "you", 3) == 0, "Second fragment not as expected");
+    cr_assert(csplit_iter_next(&iter, &fragment) == 1 && fragment.len == 13 && memcmp(fragment.text, "Hello how are", 13) == 0, "Third fragment not as expected");
+    cr_assert(csplit_iter_next(&iter, &fragment) == 0, "Fragment returned after end of split");
+    err = csplit_iter_init(&iter, "", ",", 1);
+    cr_assert(err == CSPLIT_TOO_SHORT && csplit_iter_next(&iter, &fragment) == 0, "Empty input not rejected");
+    list = NULL;
+}
+
+int count_until_empty(const CSplitView_t* fragment, void* user_data){
+    int* count = (int*) user_data;
+    if(fragment->len == 0)
+        return 1;
+    *count = *count + 1;
+    return 0;
+}
+
+Test(asserts, csplit_foreach_test, .init=setup_strings, .fini=teardown){
+    int count = 0;
+    CSplitError_t err = csplit_foreach("a,b,c,,d,e", ",", 100, count_until_empty, &count);
+    cr_assert(err == CSPLIT_SUCCESS && count == 3, "Split not stopped at empty fragment");
+    list = NULL;
+}
+
+
+/* Tests for splitting on a set of characters */
+
+Test(asserts, csplit_any_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_list();
+    CSplitError_t err = csplit_any(list, "a b,c;;d|e\tf", " \t,;|", 100);
+    cr_assert(err == CSPLIT_SUCCESS && list->num_elems == 7, "Number of fragments parsed is not as expected");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 3), "") == 0, "Empty fragment not as expected");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 4), "d") == 0, "Fragment not as expected");
+    cr_assert(strcmp(list->tail->text, "f") == 0, "Last fragment not as expected");
+}
+
+Test(asserts, csplit_charset_rlim_test, .init=setup_strings, .fini=teardown){
+    // delimiters past the first SIMD block, including a byte above 0x7F
+    const char* input = "0123456789abcdefghijklmnopqrstuvwxyz;ABCDEF\xe9GHIJ,KL";
+    CSplitCharset_t set;
+    CSplitView_t views[4];
+    size_t num_views;
+    csplit_compile_charset(&set, ",;\xe9");
+    CSplitError_t err = csplit_view_charset(views, 4, &num_views, input, &set, -2);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 3, "Number of fragments parsed is not as expected");
+    cr_assert(views[0].len == 43 && views[1].len == 4 && views[2].len == 2, "Views not as expected");
+    list = NULL;
+}
+
+
+/* Tests for splitting on runs of whitespace */
+
+Test(asserts, csplit_whitespace_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_list();
+    CSplitError_t err = csplit_whitespace(list, " \t Hello  how\n\nare\r\nyou\v\fdoing?  ", 100);
+    cr_assert(err == CSPLIT_SUCCESS && list->num_elems == 5, "Number of fragments parsed is not as expected");
+    cr_assert(strcmp(list->head->text, "Hello") == 0, "First fragment not as expected");
+    cr_assert(strcmp(csplit_get_fragment_at_index(list, 2), "are") == 0, "Fragment not as expected");
+    cr_assert(strcmp(list->tail->text, "doing?") == 0, "Last fragment not as expected");
+}
+
+Test(asserts, csplit_whitespace_lim_test, .init=setup_strings, .fini=teardown){
+    CSplitView_t views[4];
+    size_t num_views;
+    CSplitError_t err = csplit_view_whitespace(views, 4, &num_views, "  a  b  c  ", 1);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 2, "Number of fragments parsed is not as expected");
+    cr_assert(views[1].len == 6 && memcmp(views[1].text, "b  c  ", 6) == 0, "Remainder not as expected");
+    err = csplit_view_whitespace(views, 4, &num_views, "  a  b  c  ", -2);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 3, "Number of reverse fragments parsed is not as expected");
+    cr_assert(views[0].len == 3 && memcmp(views[0].text, "  a", 3) == 0, "Reverse remainder not as expected");
+    err = csplit_view_whitespace(views, 4, &num_views, " \t\n ", 100);
+    cr_assert(err == CSPLIT_SUCCESS && num_views == 0, "All whitespace input not empty");
+    list = NULL;
+}
+
+
+/* Tests for csv parsing */
+
+Test(asserts, csplit_csv_test, .init=setup_strings, .fini=teardown){
+    const char* input = "name,quote\r\n\"Smith, J\",\"said \"\"hi\"\"\nthen left\"\r\n\r\nlast,\n";
+    CSplitCsv_t csv;
+    CSplitView_t fields[4];
+    size_t num_fields;
+    cr_assert(csplit_csv_init(&csv, input, strlen(input), ',') == CSPLIT_SUCCESS, "Parser not initialized");
+    cr_assert(csplit_csv_next(&csv, fields, 4, &num_fields) == 1 && num_fields == 2, "Header not parsed");
+    cr_assert(fields[1].len == 5 && memcmp(fields[1].text, "quote", 5) == 0, "Carriage return not removed");
+    cr_assert(csplit_csv_next(&csv, fields, 4, &num_fields) == 1 && num_fields == 2, "Quoted record not parsed");
+    cr_assert(fields[0].len == 8 && memcmp(fields[0].text, "Smith, J", 8) == 0, "Quoted delimiter not kept");
+    cr_assert(fields[0].text == input + 13, "Field without doubled quotes not a view into the input");
+    cr_assert(fields[1].len == 19 && memcmp(fields[1].text, "said \"hi\"\nthen left", 19) == 0, "Doubled quotes not unescaped");
+    cr_assert(csplit_csv_next(&csv, fields, 4, &num_fields) == 1 && num_fields == 0, "Blank line not empty");
+    cr_assert(csplit_csv_next(&csv, fields, 4, &num_fields) == 1 && num_fields == 2 && fields[1].len == 0, "Last record not parsed");
+    cr_assert(csplit_csv_next(&csv, fields, 4, &num_fields) == 0, "Record returned after end of input");
+    csplit_csv_clear(&csv);
+    list = NULL;
+}
+
+Test(asserts, csplit_csv_failed_test, .init=setup_strings, .fini=teardown){
+    const char* input = "a,b,c\n\"open";
+    CSplitCsv_t csv;
+    CSplitView_t fields[3];
+    size_t num_fields;
+    csplit_csv_init(&csv, input, strlen(input), ',');
+    cr_assert(csplit_csv_next(&csv, fields, 2, &num_fields) == CSPLIT_BUFF_EXCEEDED && num_fields == 3, "Small field array not rejected");
+    cr_assert(csplit_csv_next(&csv, fields, 3, &num_fields) == 1 && num_fields == 3, "Record not parsed again");
+    cr_assert(csplit_csv_next(&csv, fields, 3, &num_fields) == CSPLIT_TOO_SHORT, "Unterminated quote not rejected");
+    csplit_csv_clear(&csv);
+    list = NULL;
+}
+
+
+/* Tests for loading configs */
+
+Test(asserts, csplit_load_config_test, .init=setup_strings, .fini=teardown){
+    const char* input = "# comment\n  INSTALL_PATH = /usr/local \r\n\nno separator here\n BUILD = yes\nBUILD=no\nEMPTY =\n";
+    CSplitConfig_t* config = csplit_load_config(input, strlen(input), "=");
+    size_t value_len = 0;
+    cr_assert(config != NULL && config->num_entries == 3, "Number of entries loaded is not as expected");
+    cr_assert(strcmp(csplit_config_get(config, "INSTALL_PATH"), "/usr/local") == 0, "Value not stripped");
+    cr_assert(strcmp(csplit_config_get(config, "BUILD"), "no") == 0, "Later value did not replace earlier one");
+    cr_assert(strcmp(csplit_config_get_n(config, "EMPTY", 5, &value_len), "") == 0 && value_len == 0, "Empty value not loaded");
+    cr_assert(csplit_config_get(config, "# comment") == NULL && csplit_config_get(config, "MISSING") == NULL, "Missing key found");
+    csplit_clear_config(config);
+    list = NULL;
+}
+
+Test(asserts, csplit_load_config_file_test, .init=setup_strings, .fini=teardown){
+    char key[32];
+    char value[32];
+    int i;
+    FILE* fp = fopen("csplit_config_test.txt", "w");
+    cr_assert(fp != NULL, "Test file not created");
+    // enough keys that the table grows several times
+    for(i = 0; i < 1000; i++)
+        fprintf(fp, "key%d: value%d\n", i, i * 2);
+    fclose(fp);
+    CSplitConfig_t* config = csplit_load_config_file("csplit_config_test.txt", ":");
+    remove("csplit_config_test.txt");
+    cr_assert(config != NULL && config->num_entries == 1000, "Number of entries loaded is not as expected");
+    for(i = 0; i < 1000; i++){
+        snprintf(key, sizeof(key), "key%d", i);
+        snprintf(value, sizeof(value), "value%d", i * 2);
+        cr_assert(strcmp(csplit_config_get(config, key), value) == 0, "Value not as expected");
+    }
+    csplit_clear_config(config);
+    list = NULL;
+}
+
+
+/* Tests for batch splitting */
+
+Test(asserts, csplit_batch_test, .init=setup_strings, .fini=teardown){
+    const char* inputs[] = {"a,b,c", "", "d", NULL, ",e,"};
+    size_t num_fragments;
+    CSplitBatch_t* batch = csplit_batch(inputs, 5, ",");
+    cr_assert(batch != NULL && batch->num_fragments == 8, "Number of fragments parsed is not as expected");
+    const CSplitView_t* fragments = csplit_batch_get(batch, 0, &num_fragments);
+    cr_assert(num_fragments == 3 && fragments[2].len == 1 && fragments[2].text[0] == 'c', "First input not as expected");
+    csplit_batch_get(batch, 1, &num_fragments);
+    cr_assert(num_fragments == 1, "Empty input does not have one fragment");
+    csplit_batch_get(batch, 3, &num_fragments);
+    cr_assert(num_fragments == 0, "NULL input has fragments");
+    fragments = csplit_batch_get(batch, 4, &num_fragments);
+    cr_assert(num_fragments == 3 && fragments[1].text == inputs[4] + 1 && fragments[2].len == 0, "Last input not as expected");
+    cr_assert(csplit_batch_get(batch, 5, &num_fragments) == NULL, "Out of range input returned");
+    csplit_clear_batch(batch);
+    list = NULL;
+}
+
+Test(asserts, csplit_batch_n_test, .init=setup_strings, .fini=teardown){
+    // inputs stored back to back
+    const char* data = "a,bc,,de,f,g";
+    size_t offsets[] = {0, 3, 3, 7, 12};
+    size_t num_fragments;
+    CSplitBatch_t* batch = csplit_batch_n(data, offsets, 4, ",", 1);
+    cr_assert(batch != NULL && batch->num_fragments == 9, "Number of fragments parsed is not as expected");
+    const CSplitView_t* fragments = csplit_batch_get(batch, 0, &num_fragments);
+    cr_assert(num_fragments == 2 && fragments[1].len == 1 && fragments[1].text == data + 2, "First input not as expected");
+    fragments = csplit_batch_get(batch, 2, &num_fragments);
+    cr_assert(num_fragments == 3 && fragments[0].len == 1 && fragments[1].len == 0 && fragments[2].text == data + 6, "Third input not as expected");
+    csplit_clear_batch(batch);
+    batch = csplit_batch_n(data, offsets, 4, ",,", 2);
+    csplit_batch_get(batch, 2, &num_fragments);
+    cr_assert(batch != NULL && num_fragments == 2, "Multiple character token not split per input");
+    csplit_clear_batch(batch);
+
+    // a token at the very start or end of an input stays in that input, giving it an empty first or last fragment
+    const char* edges = ",ab,a,,b";
+    size_t edge_offsets[] = {0, 2, 4, 6, 8};
+    batch = csplit_batch_n(edges, edge_offsets, 4, ",", 1);
+    cr_assert(batch != NULL && batch->num_fragments == 8, "Number of fragments parsed is not as expected");
+    fragments = csplit_batch_get(batch, 0, &num_fragments);
+    cr_assert(num_fragments == 2 && fragments[0].len == 0 && fragments[0].text == edges, "Empty first fragment of \",a\" not as expected");
+    cr_assert(fragments[1].len == 1 && fragments[1].text == edges + 1, "Last fragment of \",a\" not as expected");
+    fragments = csplit_batch_get(batch, 1, &num_fragments);
+    cr_assert(num_fragments == 2 && fragments[0].len == 1 && fragments[0].text == edges + 2, "First fragment of \"b,\" not as expected");
+    cr_assert(fragments[1].len == 0 && fragments[1].text == edges + 4, "Empty last fragment of \"b,\" not as expected");
+    fragments = csplit_batch_get(batch, 2, &num_fragments);
+    cr_assert(num_fragments == 2 && fragments[0].len == 1 && fragments[1].len == 0 && fragments[1].text == edges + 6, "Fragments of \"a,\" not as expected");
+    fragments = csplit_batch_get(batch, 3, &num_fragments);
+    cr_assert(num_fragments == 2 && fragments[0].len == 0 && fragments[0].text == edges + 6 && fragments[1].len == 1, "Fragments of \",b\" not as expected");
+    csplit_clear_batch(batch);
+    // the two tokens that meet at the boundary of "a," and ",b" are not one token of the inputs
+    batch = csplit_batch_n(edges, edge_offsets, 4, ",,", 2);
+    cr_assert(batch != NULL && batch->num_fragments == 4, "Token across inputs split");
+    csplit_clear_batch(batch);
+    list = NULL;
+}
+
+
+// --------------------------------------------------------
+// ----------- Tests for count then fill split ------------
+// --------------------------------------------------------
+
+Test(asserts, csplit_count_fill_test, .init=setup_strings, .fini=teardown){
+    size_t num_fragments, total_bytes;
+    CSplitError_t err = csplit_count("Hello,,World,!", ",", 10, &num_fragments, &total_bytes);
+    cr_assert(err == CSPLIT_SUCCESS && num_fragments == 4, "Number of fragments counted is not as expected");
+    cr_assert(total_bytes == 5 * sizeof(char*) + 15, "Buffer size is not as expected");
+    char** fragments = (char**) malloc(total_bytes);
+    err = csplit_fill(fragments, total_bytes, num_fragments, "Hello,,World,!", ",", 10);
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(strcmp(fragments[0], "Hello") == 0 && strcmp(fragments[1], "") == 0, "First fragments not as expected");
+    cr_assert(strcmp(fragments[2], "World") == 0 && strcmp(fragments[3], "!") == 0 && fragments[4] == NULL, "Last fragments not as expected");
+    cr_assert((char*) fragments + total_bytes == fragments[3] + 2, "Texts do not fill the buffer exactly");
+    err = csplit_fill(fragments, total_bytes - 1, num_fragments, "Hello,,World,!", ",", 10);
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED, "Too small buffer not rejected");
+    err = csplit_fill(fragments, total_bytes, num_fragments - 1, "Hello,,World,!", ",", 10);
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED, "Wrong number of fragments not rejected");
+    free(fragments);
+    list = NULL;
+}
+
+Test(asserts, csplit_count_fill_reverse_test, .init=setup_strings, .fini=teardown){
+    size_t num_fragments, total_bytes;
+    CSplitError_t err = csplit_count("a--b--c--d", "--", -2, &num_fragments, &total_bytes);
+    cr_assert(err == CSPLIT_SUCCESS && num_fragments == 3, "Number of fragments counted is not as expected");
+    char** fragments = (char**) malloc(total_bytes);
+    err = csplit_fill(fragments, total_bytes, num_fragments, "a--b--c--d", "--", -2);
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(strcmp(fragments[0], "a--b") == 0 && strcmp(fragments[1], "c") == 0 && strcmp(fragments[2], "d") == 0, "Fragments not in input order");
+    cr_assert(fragments[3] == NULL, "Pointer table not terminated");
+    free(fragments);
+    err = csplit_count("", ",", 1, &num_fragments, &total_bytes);
+    cr_assert(err == CSPLIT_TOO_SHORT, "Empty input not rejected");
+    list = NULL;
+}
+
+
+// --------------------------------------------------------
+// ------------- Tests for numeric parsing ----------------
+// --------------------------------------------------------
+
+Test(asserts, csplit_parse_int64_test, .init=setup_strings, .fini=teardown){
+    int64_t values[8];
+    CSplitError_t errors[8];
+    size_t num_values;
+    CSplitError_t err = csplit_parse_int64(values, errors, 8, &num_values, "12, -7,1234567890123,x,,99999999999999999999,-9223372036854775808", ",");
+    cr_assert(err == CSPLIT_PARSE_ERROR && num_values == 7, "Unexpected error code");
+    cr_assert(values[0] == 12 && values[1] == -7 && values[2] == INT64_C(1234567890123), "Values not parsed as expected");
+    cr_assert(errors[0] == CSPLIT_SUCCESS && errors[3] == CSPLIT_PARSE_ERROR && errors[4] == CSPLIT_PARSE_ERROR, "Invalid fields not reported");
+    cr_assert(errors[5] == CSPLIT_OUT_OF_RANGE && values[5] == 0, "Overflow not reported");
+    cr_assert(errors[6] == CSPLIT_SUCCESS && values[6] == INT64_MIN, "Smallest value not parsed");
+    err = csplit_parse_int64(values, NULL, 2, &num_values, "1,2,3", ",");
+    cr_assert(err == CSPLIT_BUFF_EXCEEDED && num_values == 3 && values[1] == 2, "Too small value array not rejected");
+    list = NULL;
+}
+
+Test(asserts, csplit_parse_double_test, .init=setup_strings, .fini=teardown){
+    double values[6];
+    CSplitError_t errors[6];
+    size_t num_values;
+    CSplitError_t err = csplit_parse_double_n(values, errors, 6, &num_values, "1.5;-0.25;3e2;0.1;1e400;abc", 27, ";", 1);
+    cr_assert(err == CSPLIT_OUT_OF_RANGE && num_values == 6, "Unexpected error code");
+    cr_assert(values[0] == 1.5 && values[1] == -0.25 && values[2] == 300.0 && values[3] == 0.1, "Values not parsed as expected");
+    cr_assert(errors[4] == CSPLIT_OUT_OF_RANGE && errors[5] == CSPLIT_PARSE_ERROR, "Invalid fields not reported");
+    double value;
+    cr_assert(csplit_view_to_double("2.2250738585072014e-308", 23, &value) == CSPLIT_SUCCESS && value == 2.2250738585072014e-308, "Long field not parsed");
+    cr_assert(csplit_view_to_double(" 7 ", 3, &value) == CSPLIT_SUCCESS && value == 7.0, "Whitespace not ignored");
+    list = NULL;
+}
+
+
+// --------------------------------------------------------
+// ------------- Tests for single field access ------------
+// --------------------------------------------------------
+
+Test(asserts, csplit_field_test, .init=setup_strings, .fini=teardown){
+    CSplitView_t field = csplit_field("a,bb,,dddd,e", ",", 1);
+    cr_assert(field.len == 2 && strncmp(field.text, "bb", 2) == 0, "Field not found as expected");
+    field = csplit_field("a,bb,,dddd,e", ",", 2);
+    cr_assert(field.text != NULL && field.len == 0, "Empty field not found");
+    field = csplit_field("a,bb,,dddd,e", ",", -2);
+    cr_assert(field.len == 4 && strncmp(field.text, "dddd", 4) == 0, "Negative index not counted from end");
+    field = csplit_field("key = value", "=", 0);
+    cr_assert(field.len == 4 && strncmp(field.text, "key ", 4) == 0, "Key not found");
+    cr_assert(csplit_field("a,bb", ",", 2).text == NULL && csplit_field("a,bb", ",", -3).text == NULL, "Out of range index returned");
+    field = csplit_field_n("x::y::z", 7, "::", 2, -1);
+    cr_assert(field.len == 1 && field.text[0] == 'z', "Multiple character token not handled");
+    list = NULL;
+}
+
+Test(asserts, csplit_fields_test, .init=setup_strings, .fini=teardown){
+    CSplitView_t fields[3];
+    size_t indexes[] = {0, 3, 4};
+    CSplitError_t err = csplit_fields(fields, indexes, 3, "id,name,x,42,y,z", ",");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    cr_assert(fields[0].len == 2 && strncmp(fields[1].text, "42", 2) == 0 && fields[2].text[0] == 'y', "Fields not found as expected");
+    size_t past_end[] = {1, 6, 7};
+    err = csplit_fields(fields, past_end, 3, "id,name,x,42,y,z", ",");
+    cr_assert(err == CSPLIT_NO_SUCH_INDEX && fields[0].len == 4 && fields[1].text == NULL && fields[2].text == NULL, "Missing field not reported");
+    size_t unsorted[] = {3, 1};
+    err = csplit_fields(fields, unsorted, 2, "id,name,x,42,y,z", ",");
+    cr_assert(err == CSPLIT_NO_SUCH_INDEX && fields[0].len == 2 && fields[1].text == NULL, "Out of order index not reported");
+    list = NULL;
+}
+
+
+// --------------------------------------------------------
+// ------------- Tests for stats counters -----------------
+// --------------------------------------------------------
+
+/* Test for the counters kept with CSPLIT_STATS */
+Test(asserts, csplit_stats_test, .init=setup_strings, .fini=teardown){
+    list = csplit_init_list();
+    csplit_reset_stats();
+    CSplitError_t err = csplit(list, "Hello Cool World!", " ");
+    cr_assert(err == CSPLIT_SUCCESS, "Unexpected error code");
+    CSplitStats_t stats = csplit_get_stats();
+    cr_assert(stats.calls[CSPLIT_CALL_LIST] == 1 && stats.calls[CSPLIT_CALL_VIEW] == 0, "Calls not counted");
+    cr_assert(stats.fragments == 3, "Fragments not counted");
+    cr_assert(stats.bytes_scanned == 17, "Scanned bytes not counted");
+    cr_assert(stats.bytes_copied == 15, "Copied bytes not counted");
+    cr_assert(stats.allocs == 6 && stats.bytes_allocated >= 18, "Allocations not counted");
+    char* stripped = csplit_strip("  abc ");
+    stats = csplit_get_stats();
+    cr_assert(stats.calls[CSPLIT_CALL_STRIP] == 1 && stats.allocs == 7 && stats.bytes_copied == 18, "Strip not counted");
+    free(stripped);
+    csplit_reset_stats();
+    stats = csplit_get_stats();
+    cr_assert(stats.allocs == 0 && stats.fragments == 0 && stats.calls[CSPLIT_CALL_LIST] == 0, "Stats not reset");
+}
+
+/* Test for the counters of a parallel split, which include the work of the helper threads */
+Test(asserts, csplit_parallel_stats_test, .init=setup_strings, .fini=teardown){
+    size_t len = 3 * CSPLIT_PARALLEL_MIN_CHUNK;
+    char* input = (char*) malloc(len);
+    size_t i;
+    for(i = 0; i < len; i++)
+        input[i] = (i % 100 == 99) ? ',' : 'a';
+    size_t num_fragments = len / 100 + 1;
+    list = csplit_init_list();
+    csplit_reset_stats();
+    CSplitError_t err = csplit_parallel(list, input, len, ",", 1, 3);
+    cr_assert(err == CSPLIT_SUCCESS && (size_t) list->num_elems == num_fragments, "Number of fragments parsed is not as expected");
+    CSplitStats_t stats = csplit_get_stats();
+    cr_assert(stats.calls[CSPLIT_CALL_PARALLEL] == 1, "Call not counted");
+    cr_assert(stats.bytes_copied == len - (num_fragments - 1), "Copies of helper threads not counted");
+    cr_assert(stats.allocs >= 2 * num_fragments, "Allocations of helper threads not counted");
+    cr_assert(stats.fragments >= num_fragments - 1 && stats.bytes_scanned >= len - len % 100, "Scans of helper threads not counted");
+    free(input);
+}